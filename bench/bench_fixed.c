@@ -0,0 +1,99 @@
+/*
+** bench_fixed.c — Scaled-int64 vs double: aggregation and formatting
+**
+** Builds one P&L column in both representations (same values, FxPnl
+** scale 1e-5 K) and compares:
+**   sum     naive double += vs int64 += (exact, vectorizes)
+**   format  snprintf("%+.1f") vs fmt_scaled()
+** The double sum's drift from the exact integer total is reported too.
+**
+** Usage: bench/bench_fixed [rows]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "fmt.h"
+
+#define DEFAULT_ROWS 1000000L
+#define SUM_REPS     50
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static volatile double  g_sink_d;
+static volatile int64_t g_sink_i;
+
+int main(int argc, char **argv) {
+  long n = (argc > 1) ? atol(argv[1]) : DEFAULT_ROWS;
+  double  *col_d = malloc(sizeof(double)  * (size_t)n);
+  int64_t *col_i = malloc(sizeof(int64_t) * (size_t)n);
+  if (!col_d || !col_i) return 1;
+
+  /* Mixed-sign P&L in K, cent resolution, wide magnitude spread */
+  uint32_t s = 12345u;
+  for (long i = 0; i < n; i++) {
+    s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+    int64_t cents = (int64_t)(s % 2000001u) - 1000000;
+    if (i % 7 == 0) cents *= 997;
+    col_i[i] = cents * 1000;                 /* 1e-5 K units = 1 cent */
+    col_d[i] = (double)col_i[i] * 1e-5;
+  }
+
+  printf("bench_fixed: %ld rows\n", n);
+
+  /* ---- Aggregation ---- */
+  double t0 = now_sec(), sum_d = 0;
+  for (int r = 0; r < SUM_REPS; r++) {
+    sum_d = 0;
+    for (long i = 0; i < n; i++) sum_d += col_d[i];
+    g_sink_d = sum_d;
+  }
+  double t_sum_d = (now_sec() - t0) / SUM_REPS;
+
+  t0 = now_sec();
+  int64_t sum_i = 0;
+  for (int r = 0; r < SUM_REPS; r++) {
+    sum_i = 0;
+    for (long i = 0; i < n; i++) sum_i += col_i[i];
+    g_sink_i = sum_i;
+  }
+  double t_sum_i = (now_sec() - t0) / SUM_REPS;
+
+  double exact = (double)sum_i * 1e-5;
+  printf("  sum    double %8.3f ms (%6.2f Grows/s)   drift %.3g K\n",
+         t_sum_d * 1e3, (double)n / t_sum_d / 1e9, sum_d - exact);
+  printf("  sum    int64  %8.3f ms (%6.2f Grows/s)   exact\n",
+         t_sum_i * 1e3, (double)n / t_sum_i / 1e9);
+
+  /* ---- Formatting ---- */
+  /* bounded values; truncation can't happen and wouldn't matter here */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+  char buf[32];
+  long bytes = 0;
+  t0 = now_sec();
+  for (long i = 0; i < n; i++) bytes += snprintf(buf, sizeof(buf), "%+.1f", col_d[i]);
+  double t_fmt_d = now_sec() - t0;
+#pragma GCC diagnostic pop
+
+  t0 = now_sec();
+  for (long i = 0; i < n; i++) {
+    bytes += fmt_scaled(buf, (int)sizeof(buf), col_i[i], FX_PNL_DIGITS, 1, FMT_PLUS);
+  }
+  double t_fmt_i = now_sec() - t0;
+  g_sink_i = bytes;
+
+  printf("  format snprintf   %8.1f ns/cell\n", t_fmt_d / (double)n * 1e9);
+  printf("  format fmt_scaled %8.1f ns/cell  (%.1fx)\n",
+         t_fmt_i / (double)n * 1e9, t_fmt_d / t_fmt_i);
+
+  free(col_i);
+  free(col_d);
+  return 0;
+}
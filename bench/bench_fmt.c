@@ -0,0 +1,178 @@
+/*
+** bench_fmt.c — Grid cell formatting: snprintf vs fmt_f64
+**
+** First checks fmt_f64 against snprintf byte-for-byte, for every format
+** the grid uses (%.0f %.1f %.2f %.3f %+.1f %+.2f), over:
+**   binary    every k / 2^12 for |k| <= 2^18: exact halves, quarters, ...
+**   decimal   every k / 1000 for |k| <= 5*10^5: the displayed domain
+**   ties      every (k + 1/2) / 10^d, |k| < 25000, d = 0..3, and both
+**             neighbouring doubles: the near-ties printf must round right
+**   random    random bit patterns over all exponents, subnormals included
+**   special   +-0, +-inf, nan, DBL_MAX, DBL_TRUE_MIN
+** plus FMT_COMMA / FMT_K / FMT_MM against snprintf of the scaled value
+** with separators inserted. Any difference prints MISMATCH and exits 1.
+**
+** Then times a grid-shaped mix (P&L, risk, prices) through both.
+**
+** Usage: bench/bench_fmt [cells]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fmt.h"
+
+#define DEFAULT_CELLS 1000000L
+#define RANDOM_VALUES 40000L
+
+/* The grid's formats as (decimals, flags) */
+#define NFMT 6
+static const int   FMT_DEC[NFMT]   = { 0, 1, 2, 3, 1, 2 };
+static const int   FMT_FLAGS[NFMT] = { 0, 0, 0, 0, FMT_PLUS, FMT_PLUS };
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t next(uint64_t *s) {
+  *s ^= *s << 13; *s ^= *s >> 7; *s ^= *s << 17;
+  return *s;
+}
+
+static volatile long g_sink;
+static long          g_checked;
+
+static int ref(char *buf, size_t cap, double v, int decimals, int flags) {
+  return snprintf(buf, cap, (flags & FMT_PLUS) ? "%+.*f" : "%.*f", decimals, v);
+}
+
+static void check(const char *set, double v) {
+  char want[512], got[512];
+  for (int f = 0; f < NFMT; f++) {
+    ref(want, sizeof(want), v, FMT_DEC[f], FMT_FLAGS[f]);
+    fmt_f64(got, (int)sizeof(got), v, FMT_DEC[f], FMT_FLAGS[f]);
+    if (strcmp(want, got) != 0) {
+      fprintf(stderr, "MISMATCH %s %.17g (%s%d): snprintf \"%s\" fmt_f64 \"%s\"\n", set, v,
+              (FMT_FLAGS[f] & FMT_PLUS) ? "+" : "", FMT_DEC[f], want, got);
+      exit(1);
+    }
+  }
+  g_checked += NFMT;
+}
+
+/* snprintf of v (pre-scaled) with separators and a suffix, built by hand */
+static void ref_flags(char *out, double v, int decimals, int flags) {
+  char raw[512];
+  if (flags & FMT_MM)     v /= 1e6;
+  else if (flags & FMT_K) v /= 1e3;
+  ref(raw, sizeof(raw), v, decimals, flags);
+  const char *p = raw;
+  if (*p == '-' || *p == '+') *out++ = *p++;
+  int ndig = (int)strspn(p, "0123456789");
+  for (int i = 0; i < ndig; i++) {
+    *out++ = *p++;
+    if ((flags & FMT_COMMA) && (ndig - 1 - i) % 3 == 0 && i < ndig - 1) *out++ = ',';
+  }
+  strcpy(out, p);
+  strcat(out, (flags & FMT_MM) ? "MM" : (flags & FMT_K) ? "K" : "");
+}
+
+static void check_flags(double v) {
+  static const int FLAGS[] = { FMT_COMMA, FMT_K, FMT_MM, FMT_COMMA | FMT_K | FMT_PLUS,
+                               FMT_COMMA | FMT_MM };
+  char want[600], got[600];
+  for (size_t i = 0; i < sizeof(FLAGS) / sizeof(FLAGS[0]); i++) {
+    for (int d = 0; d <= 3; d++) {
+      ref_flags(want, v, d, FLAGS[i]);
+      fmt_f64(got, (int)sizeof(got), v, d, FLAGS[i]);
+      if (strcmp(want, got) != 0) {
+        fprintf(stderr, "MISMATCH flags %#x %.17g (.%d): want \"%s\" fmt_f64 \"%s\"\n",
+                FLAGS[i], v, d, want, got);
+        exit(1);
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  long n = (argc > 1) ? atol(argv[1]) : DEFAULT_CELLS;
+
+  /* ---- Round trip against snprintf ---- */
+  double t0 = now_sec();
+  for (long k = -(1L << 18); k <= (1L << 18); k++) check("binary", ldexp((double)k, -12));
+  for (long k = -500000; k <= 500000; k++) check("decimal", (double)k / 1000);
+  for (int d = 0; d <= 3; d++) {
+    for (long k = -25000; k < 25000; k++) {
+      double tie = ((double)k + 0.5) / pow(10, d);
+      check("ties", tie);
+      check("ties", nextafter(tie, -INFINITY));
+      check("ties", nextafter(tie, INFINITY));
+    }
+  }
+  uint64_t s = 0x9E3779B97F4A7C15ull;
+  for (long i = 0; i < RANDOM_VALUES; i++) {
+    uint64_t bits = next(&s);
+    double   v;
+    memcpy(&v, &bits, sizeof(v));
+    if (isnan(v)) continue;                 /* sign of a nan is printf's business */
+    check("random", v);
+    if (i % 8 == 0) check_flags(v);
+  }
+  static const double SPECIAL[] = { 0.0, -0.0, INFINITY, -INFINITY, NAN,
+                                    DBL_MAX, -DBL_MAX, DBL_MIN, DBL_TRUE_MIN, 1e22, 0.5 };
+  for (size_t i = 0; i < sizeof(SPECIAL) / sizeof(SPECIAL[0]); i++) {
+    check("special", SPECIAL[i]);
+    check_flags(SPECIAL[i]);
+  }
+  for (long k = -3000000; k <= 3000000; k += 31) check_flags((double)k * 1.37);
+  printf("bench_fmt: %ld formats match snprintf (%.1f s)\n", g_checked, now_sec() - t0);
+
+  /* ---- Timing: one grid cell per value, cycling the formats ---- */
+  double *vals = malloc(sizeof(double) * (size_t)n);
+  if (!vals) return 1;
+  for (long i = 0; i < n; i++) {
+    double mag = pow(10, (double)(next(&s) % 8));            /* 1 .. 1e7 */
+    vals[i] = ((double)(next(&s) % 2000001) - 1000000) / 1e6 * mag;
+  }
+
+  /* bounded values; truncation can't happen and wouldn't matter here */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+  char buf[32];
+  long bytes = 0;
+  t0 = now_sec();
+  for (long i = 0; i < n; i++) {
+    int f = (int)(i % NFMT);
+    bytes += ref(buf, sizeof(buf), vals[i], FMT_DEC[f], FMT_FLAGS[f]);
+  }
+  double t_ref = now_sec() - t0;
+#pragma GCC diagnostic pop
+
+  t0 = now_sec();
+  for (long i = 0; i < n; i++) {
+    int f = (int)(i % NFMT);
+    bytes += fmt_f64(buf, (int)sizeof(buf), vals[i], FMT_DEC[f], FMT_FLAGS[f]);
+  }
+  double t_fmt = now_sec() - t0;
+
+  t0 = now_sec();
+  for (long i = 0; i < n; i++) {
+    bytes += fmt_f64(buf, (int)sizeof(buf), vals[i], 1, FMT_COMMA | FMT_K);
+  }
+  double t_sep = now_sec() - t0;
+  g_sink = bytes;
+
+  printf("  snprintf          %6.1f ns/cell\n", t_ref / (double)n * 1e9);
+  printf("  fmt_f64           %6.1f ns/cell  (%.1fx)\n", t_fmt / (double)n * 1e9, t_ref / t_fmt);
+  printf("  fmt_f64 ,K        %6.1f ns/cell\n", t_sep / (double)n * 1e9);
+
+  free(vals);
+  return 0;
+}
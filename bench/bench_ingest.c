@@ -0,0 +1,122 @@
+/*
+** bench_ingest.c — Aggregate ingest throughput vs number of producers
+**
+** Each producer thread owns a slice of positions (pos % P == id) and
+** publishes strictly increasing marks for them; the main thread drains the
+** hub into a book. At the end every position must carry the last mark its
+** producer published, i.e. per-position order survived the merge.
+**
+** Usage: bench/bench_ingest [events_per_producer]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sched.h>
+#include "data.h"
+#include "ingest.h"
+
+#define DEFAULT_EVENTS 1000000L
+
+typedef struct {
+  IngestHub *hub;
+  int        id;
+  int        n_prod;
+  int        n_pos;
+  long       n_events;
+  IngestKind kind;
+  double     last_px[MAX_POSITIONS];
+} Producer;
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *producer_main(void *arg) {
+  Producer *pr = arg;
+  int pos = pr->id;
+  for (long k = 0; k < pr->n_events; k++) {
+    IngestEvent ev = { .kind = pr->kind, .pos = pos };
+    if (pr->kind == INGEST_TRADE) {
+      ev.trade.qty = (k & 1) ? -1.0 : 2.0;
+      ev.trade.px  = 100.0 + (double)(k % 64) / 256.0;
+    } else {
+      ev.price.px = 100.0 + (double)k * 1e-7;
+    }
+    while (!ingest_push(pr->hub, pr->id, &ev)) sched_yield();
+    pr->last_px[pos] = (pr->kind == INGEST_TRADE) ? ev.trade.px : ev.price.px;
+    pos += pr->n_prod;
+    if (pos >= pr->n_pos) pos = pr->id;
+  }
+  return NULL;
+}
+
+static int run(IngestHub *hub, PositionBook *book, Producer *prods,
+               int n_prod, long n_events, IngestKind kind)
+{
+  data_init(book);
+  for (int i = 0; i < book->count; i++) book->items[i].mkt_price = FX_PRICE(100.0);
+
+  ingest_init(hub);
+  pthread_t th[INGEST_MAX_PRODUCERS];
+  for (int p = 0; p < n_prod; p++) {
+    prods[p] = (Producer){ .hub = hub, .id = ingest_register(hub, "bench"),
+                           .n_prod = n_prod, .n_pos = book->count,
+                           .n_events = n_events, .kind = kind };
+  }
+
+  double t0 = now_sec();
+  for (int p = 0; p < n_prod; p++) pthread_create(&th[p], NULL, producer_main, &prods[p]);
+
+  long total = n_events * n_prod, applied = 0;
+  while (applied < total) {
+    int n = ingest_drain(hub, book, 1 << 16);
+    if (n == 0) sched_yield();
+    applied += n;
+  }
+  double dt = now_sec() - t0;
+  for (int p = 0; p < n_prod; p++) pthread_join(th[p], NULL);
+
+  int bad = 0;
+  for (int i = 0; kind == INGEST_PRICE && i < book->count; i++) {
+    const Producer *owner = &prods[i % n_prod];
+    if (book->items[i].mkt_price != FX_PRICE(owner->last_px[i])) bad++;
+  }
+
+  uint64_t stalls = 0;
+  for (int p = 0; p < n_prod; p++) stalls += hub->rings[p].stalls;
+
+  printf("  %-6s producers=%d  events=%9ld  %7.3fs  %8.2f Mev/s  stalls=%llu  %s\n",
+         kind == INGEST_TRADE ? "fills" : "marks", n_prod, total, dt,
+         (double)total / dt / 1e6, (unsigned long long)stalls,
+         bad ? "ORDER VIOLATION" : (kind == INGEST_PRICE ? "ordered" : ""));
+  return bad;
+}
+
+int main(int argc, char **argv) {
+  long n_events = (argc > 1) ? atol(argv[1]) : DEFAULT_EVENTS;
+  IngestHub    *hub   = aligned_alloc(INGEST_CACHE_LINE, sizeof(IngestHub));
+  PositionBook *book  = malloc(sizeof(PositionBook));
+  Producer     *prods = malloc(sizeof(Producer) * INGEST_MAX_PRODUCERS);
+  if (!hub || !book || !prods) return 1;
+
+  printf("bench_ingest: %ld events/producer, ring=%d, burst=%d\n",
+         n_events, INGEST_RING_CAP, INGEST_BURST);
+
+  static const int counts[] = { 1, 2, 3, 4, 6, 8 };
+  int fails = 0;
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+    fails += run(hub, book, prods, counts[c], n_events, INGEST_PRICE);
+  }
+  fails += run(hub, book, prods, 1, n_events, INGEST_TRADE);
+
+  free(prods);
+  free(book);
+  free(hub);
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+/*
+** bench_lookup.c — Instrument lookup: prefix index vs linear scan
+**
+** Generates an instrument universe (names + CUSIPs, two keys per
+** instrument), builds the lookup index and times type-ahead queries
+** against a linear scan that tests every name and CUSIP for all query
+** tokens (what the filter box did per keystroke). Every index hit must
+** contain each token at least as an in-order subsequence.
+**
+** Usage: bench/bench_lookup [instruments]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lookup.h"
+#include "strmatch.h"
+
+#define DEFAULT_INSTRUMENTS 1000000
+#define NAME_CAP            40
+#define CUSIP_CAP           12
+#define TOP_K               8
+#define REPS                200
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static const char *CCY[] = { "USD", "EUR", "GBP", "JPY", "CHF", "AUD" };
+static const char *IDX[] = { "SOFR", "ESTR", "SONIA", "TONA", "SARON" };
+
+#define PICK(a, s) (a[(s) % (sizeof(a) / sizeof(a[0]))])
+
+static uint32_t next(uint32_t *s) {
+  *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+  return *s;
+}
+
+static void make_name(char *dst, uint32_t *s) {
+  uint32_t k = next(s);
+  switch (k % 4) {
+    case 0: snprintf(dst, NAME_CAP, "UST %uY %u.%03u %02u/%02u",
+                     1 + k / 3 % 30, 1 + k / 7 % 6, k / 11 % 1000,
+                     1 + k / 13 % 12, 25 + k / 17 % 30);
+            break;
+    case 1: snprintf(dst, NAME_CAP, "%s %s %uY IRS",
+                     PICK(CCY, k / 3), PICK(IDX, k / 5), 1 + k / 7 % 30);
+            break;
+    case 2: snprintf(dst, NAME_CAP, "%s %uMx%uY Payer",
+                     PICK(CCY, k / 3), 1 + k / 5 % 24, 1 + k / 7 % 30);
+            break;
+    default: snprintf(dst, NAME_CAP, "%s %s FUT %c%u",
+                      PICK(CCY, k / 3), (k & 64) ? "TY" : "FV",
+                      "HMUZ"[k / 5 % 4], 5 + k / 7 % 5);
+            break;
+  }
+}
+
+static const char *QUERIES[] = {
+  "ust 10", "sofr 5y", "91282c4", "eur payer", "gbp sonia 10",
+  "ust10", "ty fut", "u", "zzz"
+};
+#define N_QUERIES (int)(sizeof(QUERIES) / sizeof(QUERIES[0]))
+
+/* Linear baseline: every token a case-insensitive substring of the name
+   or the CUSIP */
+static int scan_all(const char *names, const char *cusips, int n, const char *q) {
+  char tok[LK_MAX_TOKENS][32];
+  int  nt = 0;
+  char buf[128];
+  snprintf(buf, sizeof(buf), "%s", q);
+  for (char *t = strtok(buf, " "); t && nt < LK_MAX_TOKENS; t = strtok(NULL, " ")) {
+    snprintf(tok[nt++], sizeof(tok[0]), "%s", t);
+  }
+  int hits = 0;
+  for (int i = 0; i < n; i++) {
+    const char *nm = names + (size_t)i * NAME_CAP, *cu = cusips + (size_t)i * CUSIP_CAP;
+    int ok = 1;
+    for (int t = 0; t < nt && ok; t++) {
+      ok = sm_contains_ci(nm, tok[t]) || sm_contains_ci(cu, tok[t]);
+    }
+    hits += ok;
+  }
+  return hits;
+}
+
+static int subsequence_ci(const char *s, const char *tok) {
+  char ls[64], lt[32];
+  sm_lower(ls, (int)sizeof(ls), s);
+  sm_lower(lt, (int)sizeof(lt), tok);
+  const char *p = ls;
+  for (const char *c = lt; *c; c++) {
+    p = strchr(p, *c);
+    if (!p) return 0;
+    p++;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  int n = (argc > 1) ? atoi(argv[1]) : DEFAULT_INSTRUMENTS;
+  char   *names  = malloc((size_t)n * NAME_CAP);
+  char   *cusips = malloc((size_t)n * CUSIP_CAP);
+  int     text_cap  = n * (NAME_CAP + CUSIP_CAP) + SM_PAD;
+  int     keys_cap  = 2 * n;
+  int     words_cap = 8 * n;
+  char   *text  = malloc((size_t)text_cap);
+  LkKey  *keys  = malloc(sizeof(LkKey) * (size_t)keys_cap);
+  LkWord *words = malloc(sizeof(LkWord) * (size_t)words_cap);
+  if (!names || !cusips || !text || !keys || !words) return 1;
+
+  uint32_t s = 2463534242u;
+  for (int i = 0; i < n; i++) {
+    make_name(names + (size_t)i * NAME_CAP, &s);
+    snprintf(cusips + (size_t)i * CUSIP_CAP, CUSIP_CAP, "91282C%03X", (unsigned)i % 4096);
+  }
+
+  Lookup lk;
+  lk_init(&lk, text, text_cap, keys, keys_cap, words, words_cap);
+  double t0 = now_sec();
+  for (int i = 0; i < n; i++) {
+    if (lk_add(&lk, names + (size_t)i * NAME_CAP, i, 0) != 0 ||
+        lk_add(&lk, cusips + (size_t)i * CUSIP_CAP, i, 1) != 0) {
+      fprintf(stderr, "index full at %d\n", i);
+      return 1;
+    }
+  }
+  lk_finish(&lk);
+  double t_build = now_sec() - t0;
+
+  printf("bench_lookup: %d instruments, %d keys, %d words, build %.0f ms\n",
+         n, lk.nkeys, lk.nwords, t_build * 1e3);
+  printf("  %-14s %6s %10s %9s %10s %8s  %s\n",
+         "query", "top-k", "index us", "scan hits", "scan ms", "speedup", "top match");
+
+  for (int q = 0; q < N_QUERIES; q++) {
+    LkHit hits[TOP_K];
+    int   nh = 0;
+    t0 = now_sec();
+    for (int r = 0; r < REPS; r++) nh = lk_query(&lk, QUERIES[q], hits, TOP_K);
+    double t_idx = (now_sec() - t0) / REPS;
+
+    t0 = now_sec();
+    int scanned = scan_all(names, cusips, n, QUERIES[q]);
+    double t_scan = now_sec() - t0;
+
+    /* Every hit must contain each token as an in-order subsequence */
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", QUERIES[q]);
+    for (char *t = strtok(buf, " "); t; t = strtok(NULL, " ")) {
+      for (int h = 0; h < nh; h++) {
+        const char *key = lk.text + lk.keys[hits[h].key].off;
+        if (!subsequence_ci(key, t)) {
+          fprintf(stderr, "BAD HIT for \"%s\": %s\n", QUERIES[q], key);
+          return 1;
+        }
+      }
+    }
+
+    printf("  %-14s %6d %10.1f %9d %10.2f %7.0fx  %s\n", QUERIES[q], nh,
+           t_idx * 1e6, scanned, t_scan * 1e3, t_scan / (t_idx > 0 ? t_idx : 1e-9),
+           nh ? lk.text + lk.keys[hits[0].key].off : "-");
+  }
+
+  free(words);
+  free(keys);
+  free(text);
+  free(cusips);
+  free(names);
+  return 0;
+}
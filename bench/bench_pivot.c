@@ -0,0 +1,183 @@
+/*
+** bench_pivot.c — Pivot cube: delta updates vs rebuilding
+**
+** A 100k-position universe pivoted 200 row keys x 20 column keys (up to
+** 4000 cells) over four measures. Times a full build, a frame's worth of
+** reads (every row x column cell, as the screen draws them), and single
+** position ticks applied by delta. After a million ticks, every cell and
+** total must match a cube rebuilt from scratch.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pivot.h"
+
+#define N_SRC    100000
+#define N_RKEYS  200
+#define N_CKEYS  20
+#define N_TICKS  1000000
+#define NM       PIVOT_MAX_MEASURES
+#define REPS     5
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t next(uint32_t *s) {
+  *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+  return *s;
+}
+
+static double rnd(uint32_t *s, double scale) {
+  return ((double)(int32_t)next(s) / 2147483648.0) * scale;
+}
+
+/* Heap storage for a cube over N_SRC rows */
+static int pivot_alloc(Pivot *pv) {
+  memset(pv, 0, sizeof(*pv));
+  pv->nmeasures = NM;
+  pv->cells_cap = N_RKEYS * N_CKEYS;
+  pv->slot_bits = 14;                               /* 16384 >= 2 x 4000 */
+  pv->rows_cap  = N_RKEYS;
+  pv->cols_cap  = N_CKEYS;
+  pv->src_cap   = N_SRC;
+  pv->cells    = malloc(sizeof(PivotCell) * (size_t)pv->cells_cap);
+  pv->slots    = malloc(sizeof(uint32_t) << pv->slot_bits);
+  pv->rows     = malloc(sizeof(PivotHead) * (size_t)pv->rows_cap);
+  pv->cols     = malloc(sizeof(PivotHead) * (size_t)pv->cols_cap);
+  pv->src_cell = malloc(sizeof(uint32_t) * N_SRC);
+  pv->src_vals = malloc(sizeof(double) * N_SRC * NM);
+  if (!pv->cells || !pv->slots || !pv->rows || !pv->cols || !pv->src_cell || !pv->src_vals) return -1;
+  pivot_reset(pv);
+  return 0;
+}
+
+static void pivot_free(Pivot *pv) {
+  free(pv->src_vals);
+  free(pv->src_cell);
+  free(pv->cols);
+  free(pv->rows);
+  free(pv->slots);
+  free(pv->cells);
+}
+
+static uint32_t s_rkey[N_SRC], s_ckey[N_SRC];
+static double   s_vals[N_SRC][NM];
+
+static void build(Pivot *pv) {
+  pivot_reset(pv);
+  for (int i = 0; i < N_SRC; i++) pivot_set_row(pv, i, s_rkey[i], s_ckey[i], s_vals[i]);
+}
+
+/* Read every cell of the grid the way the screen does; returns a checksum */
+static double frame(const Pivot *pv) {
+  double sum = 0;
+  for (int r = 0; r < pv->nrows; r++) {
+    for (int c = 0; c < pv->ncols; c++) {
+      const PivotCell *cell = pivot_cell(pv, pv->rows[r].key, pv->cols[c].key);
+      if (cell) sum += cell->sum[0];
+    }
+    sum += pv->rows[r].sum[0];
+  }
+  return sum;
+}
+
+static int close_to(double a, double b) {
+  return fabs(a - b) <= 1e-6 * (fabs(a) + fabs(b) + 1.0);
+}
+
+int main(void) {
+  static Pivot live, fresh;
+  if (pivot_alloc(&live) || pivot_alloc(&fresh)) return 1;
+
+  /* Row keys skewed towards a few big desks, columns uniform */
+  uint32_t s = 2463534242u;
+  for (int i = 0; i < N_SRC; i++) {
+    uint32_t k = next(&s);
+    s_rkey[i] = (k % 4 == 0) ? k % 8 : next(&s) % N_RKEYS;
+    s_ckey[i] = next(&s) % N_CKEYS;
+    s_vals[i][0] = rnd(&s, 5e3);                    /* DV01 */
+    s_vals[i][1] = rnd(&s, 2e2);                    /* vega */
+    s_vals[i][2] = rnd(&s, 5e1);                    /* day P&L (K) */
+    s_vals[i][3] = rnd(&s, 1e2);                    /* notional (MM) */
+  }
+
+  double t_build = 1e9;
+  for (int r = 0; r < REPS; r++) {
+    double t0 = now_sec();
+    build(&live);
+    double t = now_sec() - t0;
+    if (t < t_build) t_build = t;
+  }
+
+  double t_frame = 1e9, check = 0;
+  for (int r = 0; r < REPS; r++) {
+    double t0 = now_sec();
+    check += frame(&live);
+    double t = now_sec() - t0;
+    if (t < t_frame) t_frame = t;
+  }
+
+  /* Ticks: a random position re-marks every measure */
+  uint32_t *tick_row = malloc(sizeof(uint32_t) * N_TICKS);
+  if (!tick_row) return 1;
+  for (int i = 0; i < N_TICKS; i++) tick_row[i] = next(&s) % N_SRC;
+  double t0 = now_sec();
+  for (int i = 0; i < N_TICKS; i++) {
+    int row = (int)tick_row[i];
+    for (int m = 0; m < NM; m++) s_vals[row][m] += s_vals[row][m] * 1e-3 + 0.25;
+    pivot_set_row(&live, row, s_rkey[row], s_ckey[row], s_vals[row]);
+  }
+  double t_ticks = now_sec() - t0;
+
+  /* The delta-maintained cube must agree with a rebuild */
+  build(&fresh);
+  if (fresh.ncells != live.ncells || fresh.nrows != live.nrows || fresh.ncols != live.ncols) {
+    fprintf(stderr, "MISMATCH shape\n");
+    return 1;
+  }
+  for (int i = 0; i < fresh.ncells; i++) {
+    const PivotCell *want = &fresh.cells[i];
+    const PivotCell *got  = pivot_cell(&live, want->rkey, want->ckey);
+    if (!got || got->count != want->count) {
+      fprintf(stderr, "MISMATCH cell %d\n", i);
+      return 1;
+    }
+    for (int m = 0; m < NM; m++) {
+      if (!close_to(got->sum[m], want->sum[m]) ||
+          !close_to(live.rows[got->r].sum[m], fresh.rows[want->r].sum[m]) ||
+          !close_to(live.cols[got->c].sum[m], fresh.cols[want->c].sum[m])) {
+        fprintf(stderr, "MISMATCH cell %d measure %d\n", i, m);
+        return 1;
+      }
+    }
+  }
+  for (int m = 0; m < NM; m++) {
+    if (!close_to(live.total.sum[m], fresh.total.sum[m])) {
+      fprintf(stderr, "MISMATCH total measure %d\n", m);
+      return 1;
+    }
+  }
+
+  double ns_tick = t_ticks / N_TICKS * 1e9;
+  printf("bench_pivot: %d positions, %d x %d = %d cells, %d measures (checksum %.3g)\n",
+         N_SRC, live.nrows, live.ncols, live.ncells, NM, check);
+  printf("  full build      %9.2f ms\n", t_build * 1e3);
+  printf("  frame read      %9.2f us  (every cell + row totals)\n", t_frame * 1e6);
+  printf("  tick by delta   %9.1f ns  (%d ticks; %.0fx cheaper than a rebuild)\n",
+         ns_tick, N_TICKS, t_build * 1e9 / ns_tick);
+  printf("  10k ticks/frame %9.2f ms\n", ns_tick * 1e4 * 1e-6);
+
+  free(tick_row);
+  pivot_free(&fresh);
+  pivot_free(&live);
+  return 0;
+}
@@ -0,0 +1,165 @@
+/*
+** bench_sort.c — Full sort: LSD radix over (key, row) vs qsort
+**
+** Sorts a column of P&L-like doubles, and a column of interned desk
+** names, at several book sizes. The baseline is qsort with a comparison
+** callback (value, then row index); the radix path converts each double
+** to an order-preserving uint64 (or each name id to its precomputed
+** collation rank) and runs sort_radix() serially and threaded. Every
+** radix result must match qsort's order exactly.
+**
+** Usage: bench/bench_sort [threads]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sort.h"
+
+#define REPS    5
+#define N_NAMES 64
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t next(uint32_t *s) {
+  *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+  return *s;
+}
+
+typedef struct {
+  double   v;
+  uint32_t row;
+} DblRow;
+
+static int cmp_dbl(const void *pa, const void *pb) {
+  const DblRow *a = pa, *b = pb;
+  if (a->v != b->v) return (a->v < b->v) ? -1 : 1;
+  return (a->row > b->row) - (a->row < b->row);
+}
+
+static char s_names[N_NAMES][16];
+
+typedef struct {
+  uint8_t  id;
+  uint32_t row;
+} NameRow;
+
+static int cmp_name(const void *pa, const void *pb) {
+  const NameRow *a = pa, *b = pb;
+  int c = strcmp(s_names[a->id], s_names[b->id]);
+  if (c) return c;
+  return (a->row > b->row) - (a->row < b->row);
+}
+
+/* Best of REPS for one radix run; a[] is rebuilt from keys each rep */
+static double time_radix(SortPair *a, SortPair *tmp, const uint64_t *keys,
+                         size_t n, int threads)
+{
+  double best = 1e9;
+  for (int r = 0; r < REPS; r++) {
+    double t0 = now_sec();
+    for (size_t i = 0; i < n; i++) a[i] = (SortPair){ keys[i], (uint32_t)i };
+    sort_radix(a, tmp, n, threads);
+    double t = now_sec() - t0;
+    if (t < best) best = t;
+  }
+  return best;
+}
+
+int main(int argc, char **argv) {
+  long cpus    = sysconf(_SC_NPROCESSORS_ONLN);
+  int  threads = (argc > 1) ? atoi(argv[1]) : (int)(cpus > 0 ? cpus : 1);
+  if (threads < 2) threads = 2;
+  if (threads > SORT_MAX_THREADS) threads = SORT_MAX_THREADS;
+
+  static const size_t SIZES[] = { 10000, 100000, 1000000 };
+  size_t    max = SIZES[2];
+  double   *vals  = malloc(sizeof(double) * max);
+  uint8_t  *ids   = malloc(max);
+  uint64_t *keys  = malloc(sizeof(uint64_t) * max);
+  DblRow   *dr    = malloc(sizeof(DblRow) * max);
+  NameRow  *nr    = malloc(sizeof(NameRow) * max);
+  SortPair *a     = malloc(sizeof(SortPair) * max);
+  SortPair *tmp   = malloc(sizeof(SortPair) * max);
+  if (!vals || !ids || !keys || !dr || !nr || !a || !tmp) return 1;
+
+  /* Names in id order are not sorted; ranks give their collation order */
+  uint32_t s = 2463534242u;
+  uint32_t rank[N_NAMES];
+  for (int i = 0; i < N_NAMES; i++) {
+    snprintf(s_names[i], sizeof(s_names[i]), "DESK-%c%c%02u",
+             'A' + (int)(next(&s) % 26), 'A' + (int)(next(&s) % 26), (unsigned)i);
+  }
+  for (int i = 0; i < N_NAMES; i++) {
+    rank[i] = 0;
+    for (int j = 0; j < N_NAMES; j++) rank[i] += strcmp(s_names[j], s_names[i]) < 0;
+  }
+
+  for (size_t i = 0; i < max; i++) {
+    /* Day P&L: mostly small, some large, both signs, some exact zeros */
+    uint32_t k = next(&s);
+    vals[i] = (k % 16 == 0) ? 0.0 : ((double)(int32_t)k / 2147483648.0) * ((k & 3) ? 5e4 : 5e6);
+    ids[i]  = (uint8_t)(next(&s) % N_NAMES);
+  }
+
+  printf("bench_sort: best of %d, %d threads for the threaded radix\n", REPS, threads);
+  printf("  %-6s %9s %10s %10s %10s %8s %8s\n",
+         "key", "rows", "qsort ms", "radix ms", "thread ms", "speedup", "thr x");
+
+  for (int kind = 0; kind < 2; kind++) {
+    for (int si = 0; si < 3; si++) {
+      size_t n = SIZES[si];
+
+      double t_q = 1e9;
+      for (int r = 0; r < REPS; r++) {
+        double t0 = now_sec();
+        if (kind == 0) {
+          for (size_t i = 0; i < n; i++) dr[i] = (DblRow){ vals[i], (uint32_t)i };
+          qsort(dr, n, sizeof(DblRow), cmp_dbl);
+        } else {
+          for (size_t i = 0; i < n; i++) nr[i] = (NameRow){ ids[i], (uint32_t)i };
+          qsort(nr, n, sizeof(NameRow), cmp_name);
+        }
+        double t = now_sec() - t0;
+        if (t < t_q) t_q = t;
+      }
+
+      /* Key conversion is part of the radix cost */
+      double t0 = now_sec();
+      for (size_t i = 0; i < n; i++) keys[i] = kind ? rank[ids[i]] : sort_key_f64(vals[i]);
+      double t_key = now_sec() - t0;
+
+      double t_r = time_radix(a, tmp, keys, n, 1) + t_key;
+      double t_p = time_radix(a, tmp, keys, n, threads) + t_key;
+
+      for (size_t i = 0; i < n; i++) {
+        uint32_t want = kind ? nr[i].row : dr[i].row;
+        if (a[i].row != want) {
+          fprintf(stderr, "MISMATCH %s n=%zu at %zu\n", kind ? "name" : "f64", n, i);
+          return 1;
+        }
+      }
+
+      printf("  %-6s %9zu %10.2f %10.2f %10.2f %7.1fx %7.1fx\n", kind ? "name" : "f64",
+             n, t_q * 1e3, t_r * 1e3, t_p * 1e3, t_q / t_r, t_r / t_p);
+    }
+  }
+
+  free(tmp);
+  free(a);
+  free(nr);
+  free(dr);
+  free(keys);
+  free(ids);
+  free(vals);
+  return 0;
+}
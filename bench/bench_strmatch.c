@@ -0,0 +1,179 @@
+/*
+** bench_strmatch.c — Filter-box substring match: byte loop vs strmatch
+**
+** Generates realistic rates-desk rows (instrument, cusip, book, desk) and
+** runs a set of typical filter queries over all of them with:
+**   byte loop   the original str_contains_ci (strlen + lowercase both sides)
+**   contains    sm_contains_ci on the raw fields (needle lowered once)
+**   sm_find     pre-lowercased padded haystack, AVX2 first/last filter
+** Every method must report the same match count per query.
+**
+** Usage: bench/bench_strmatch [rows]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "strmatch.h"
+
+#define DEFAULT_ROWS 200000
+#define REPS         5
+#define HAY_CAP      128
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* The matcher screen.c used before strmatch */
+static int str_contains_ci(const char *haystack, const char *needle) {
+  if (!needle[0]) return 1;
+  int nlen = (int)strlen(needle);
+  int hlen = (int)strlen(haystack);
+  if (nlen > hlen) return 0;
+
+  for (int i = 0; i <= hlen - nlen; i++) {
+    int match = 1;
+    for (int j = 0; j < nlen && match; j++) {
+      char a = haystack[i + j];
+      char b = needle[j];
+      if (a >= 'A' && a <= 'Z') a = (char)(a + 32);
+      if (b >= 'A' && b <= 'Z') b = (char)(b + 32);
+      if (a != b) match = 0;
+    }
+    if (match) return 1;
+  }
+  return 0;
+}
+
+typedef struct {
+  char inst[40], cusip[12], book[16], desk[16];
+} Row;
+
+static const char *CCY[]   = { "USD", "EUR", "GBP", "JPY", "CHF", "AUD" };
+static const char *IDX[]   = { "SOFR", "ESTR", "SONIA", "TONA", "SARON" };
+static const char *BOOKS[] = { "UST Flow", "Swaps MM", "Vol Desk", "Gilts",
+                               "Bund RV", "Curve", "Basis" };
+static const char *DESKS[] = { "Rates NY", "Rates LDN", "USD Vol", "EUR Vol",
+                               "Govt Trd", "STIR" };
+
+#define PICK(a, s) (a[(s) % (sizeof(a) / sizeof(a[0]))])
+
+static uint32_t next(uint32_t *s) {
+  *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+  return *s;
+}
+
+static void make_row(Row *r, uint32_t *s) {
+  uint32_t k = next(s);
+  switch (k % 4) {
+    case 0: snprintf(r->inst, sizeof(r->inst), "UST %u.%03u %02u/%02u",
+                     1 + k / 7 % 6, k / 11 % 1000, 1 + k / 13 % 12, 25 + k / 17 % 30);
+            break;
+    case 1: snprintf(r->inst, sizeof(r->inst), "%s %s %uY IRS",
+                     PICK(CCY, k / 3), PICK(IDX, k / 5), 1 + k / 7 % 30);
+            break;
+    case 2: snprintf(r->inst, sizeof(r->inst), "%s %uMx%uY Payer",
+                     PICK(CCY, k / 3), 1 + k / 5 % 24, 1 + k / 7 % 30);
+            break;
+    default: snprintf(r->inst, sizeof(r->inst), "%s %s FUT %c%u",
+                      PICK(CCY, k / 3), (k & 64) ? "TY" : "FV",
+                      "HMUZ"[k / 5 % 4], 5 + k / 7 % 5);
+            break;
+  }
+  snprintf(r->cusip, sizeof(r->cusip), "91282C%03X", next(s) % 4096);
+  snprintf(r->book,  sizeof(r->book),  "%s", PICK(BOOKS, next(s)));
+  snprintf(r->desk,  sizeof(r->desk),  "%s", PICK(DESKS, next(s)));
+}
+
+static const char *QUERIES[] = {
+  "ust", "SOFR", "10Y", "payer", "91282CA", "vol", "gbp sonia", "zzz", "Z9"
+};
+#define N_QUERIES (int)(sizeof(QUERIES) / sizeof(QUERIES[0]))
+
+int main(int argc, char **argv) {
+  int n = (argc > 1) ? atoi(argv[1]) : DEFAULT_ROWS;
+  Row  *rows = malloc(sizeof(Row) * (size_t)n);
+  char *hay  = calloc((size_t)n, HAY_CAP);
+  int  *hlen = malloc(sizeof(int) * (size_t)n);
+  if (!rows || !hay || !hlen) return 1;
+
+  /* Build rows and their lowercased, separator-joined haystacks */
+  uint32_t s = 2463534242u;
+  for (int i = 0; i < n; i++) {
+    make_row(&rows[i], &s);
+    char *h = hay + (size_t)i * HAY_CAP;
+    int   cap = HAY_CAP - SM_PAD, len = 0;
+    const char *f[4] = { rows[i].inst, rows[i].cusip, rows[i].book, rows[i].desk };
+    for (int k = 0; k < 4; k++) {
+      if (len) h[len++] = '\x1f';
+      len += sm_lower(h + len, cap - len, f[k]);
+    }
+    hlen[i] = len;
+  }
+
+  printf("bench_strmatch: %d rows, %d queries, avx2 %s\n", n, N_QUERIES,
+         sm_simd_active() ? "active" : "inactive");
+  printf("  %-10s %8s %10s %10s %10s %7s\n",
+         "query", "matches", "byte ms", "contains", "sm_find", "speedup");
+
+  double tot_old = 0, tot_new = 0;
+  for (int q = 0; q < N_QUERIES; q++) {
+    const char *nd = QUERIES[q];
+    char lnd[64];
+    int  lnl = sm_lower(lnd, (int)sizeof(lnd), nd);
+    int  c_old = 0, c_ci = 0, c_new = 0;
+
+    double t0 = now_sec();
+    for (int r = 0; r < REPS; r++) {
+      c_old = 0;
+      for (int i = 0; i < n; i++) {
+        const Row *w = &rows[i];
+        c_old += str_contains_ci(w->inst, nd) || str_contains_ci(w->cusip, nd) ||
+                 str_contains_ci(w->book, nd) || str_contains_ci(w->desk, nd);
+      }
+    }
+    double t_old = (now_sec() - t0) / REPS;
+
+    t0 = now_sec();
+    for (int r = 0; r < REPS; r++) {
+      c_ci = 0;
+      for (int i = 0; i < n; i++) {
+        const Row *w = &rows[i];
+        c_ci += sm_contains_ci(w->inst, nd) || sm_contains_ci(w->cusip, nd) ||
+                sm_contains_ci(w->book, nd) || sm_contains_ci(w->desk, nd);
+      }
+    }
+    double t_ci = (now_sec() - t0) / REPS;
+
+    t0 = now_sec();
+    for (int r = 0; r < REPS; r++) {
+      c_new = 0;
+      for (int i = 0; i < n; i++) {
+        c_new += sm_find(hay + (size_t)i * HAY_CAP, hlen[i], lnd, lnl);
+      }
+    }
+    double t_new = (now_sec() - t0) / REPS;
+
+    if (c_old != c_ci || c_old != c_new) {
+      fprintf(stderr, "MISMATCH on \"%s\": %d / %d / %d\n", nd, c_old, c_ci, c_new);
+      return 1;
+    }
+    tot_old += t_old;
+    tot_new += t_new;
+    printf("  %-10s %8d %10.3f %10.3f %10.3f %6.1fx\n", nd, c_old,
+           t_old * 1e3, t_ci * 1e3, t_new * 1e3, t_old / t_new);
+  }
+  printf("  all queries: byte loop %.2f ms, sm_find %.2f ms (%.1fx)\n",
+         tot_old * 1e3, tot_new * 1e3, tot_old / tot_new);
+
+  free(hlen);
+  free(hay);
+  free(rows);
+  return 0;
+}
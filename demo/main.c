@@ -26,16 +26,26 @@
 #include "bbg_tui.h"
 #include "theme.h"
 #include "data.h"
+#include "ingest.h"
+#include "feed.h"
 #include "screen.h"
+#include "worker.h"
 #include "poms.h"
 
 /* ---- Default Window Size ---- */
 #define DEFAULT_WIN_W 1024
 #define DEFAULT_WIN_H 720
 
+/* ---- Max feed events applied per frame (keeps frame time bounded) ---- */
+#define INGEST_FRAME_BUDGET 65536
+
 /* ---- Global State ---- */
 static PositionBook g_book;
+static IngestHub g_ingest;
+static FeedSim g_feeds;
 static ScreenManager g_screens;
+static Movers g_movers;
+static VegaCube g_vega;
 static int g_tick = 0;
 static int g_win_w = DEFAULT_WIN_W;
 static int g_win_h = DEFAULT_WIN_H;
@@ -106,7 +116,20 @@ static void process_frame(mu_Context *ctx) {
 
     /* ---- Render Active Screen's POMS Grid ---- */
     Screen *active = screen_mgr_active(&g_screens);
-    poms_render(ctx, active, &g_book, g_tick);
+    if (active->kind == SCREEN_MOVERS) {
+      poms_render_movers(ctx, &g_movers, &g_book);
+    } else if (active->kind == SCREEN_PIVOT) {
+      poms_render_pivot(ctx, active, &g_book);
+    } else if (active->kind == SCREEN_LADDER) {
+      poms_render_ladder(ctx, active, &g_book);
+    } else if (active->kind == SCREEN_VEGA) {
+      poms_render_vega(ctx, active, &g_vega, &g_book);
+    } else {
+      poms_render(ctx, active, &g_book, g_tick);
+    }
+
+    /* ---- Keep every view current for instant tab switches ---- */
+    screen_mgr_refresh(&g_screens, &g_book);
 
     mu_end_window(ctx);
   }
@@ -171,14 +194,39 @@ int main(int argc, char **argv) {
   (void)argc; (void)argv;
   srand((unsigned)time(NULL));
 
-  /* init data */
+  /* init data + feed threads (prices, trades, risk) */
   data_init(&g_book);
+  ingest_init(&g_ingest);
+  if (feed_start(&g_feeds, &g_ingest, &g_book) != 0) {
+    fprintf(stderr, "feed_start failed\n");
+    return 1;
+  }
+
+  /* filter worker (falls back to inline evaluation if it can't start) */
+  if (worker_start() != 0) {
+    fprintf(stderr, "worker_start failed, filtering on the UI thread\n");
+  }
+
+  /* named views: materialized once, shared by every screen on that filter */
+  screen_view_define("BONDS",       &(ScreenFilter){ .show_bonds = 1 });
+  screen_view_define("SWAPS",       &(ScreenFilter){ .show_swaps = 1 });
+  screen_view_define("VOL",         &(ScreenFilter){ .show_swaptions = 1 });
+  screen_view_define("USD SWAPS",   &(ScreenFilter){ .search = "usd", .show_swaps = 1 });
+  screen_view_define("NEG DAY P&L", &(ScreenFilter){ .search = "pnl_day < 0",
+                                      .show_bonds = 1, .show_swaps = 1,
+                                      .show_futures = 1, .show_swaptions = 1 });
 
   /* init screen manager with preset screens */
   screen_mgr_init(&g_screens);
   screen_mgr_add_preset(&g_screens, "BONDS",  1, 0, 0, 0);
   screen_mgr_add_preset(&g_screens, "SWAPS",  0, 1, 0, 0);
   screen_mgr_add_preset(&g_screens, "VOL",    0, 0, 0, 1);
+  screen_mgr_add_movers(&g_screens, "MOVERS");
+  screen_mgr_add_pivot(&g_screens, "PIVOT",
+                       &(PivotDef){ { { GROUP_DESK }, 1 }, { { GROUP_ASSET }, 1 } },
+                       PIVOT_DV01);
+  screen_mgr_add_ladder(&g_screens, "LADDER", 1, 1, 1, 1);
+  screen_mgr_add_vega(&g_screens, "VEGA");
 
   /* init SDL + renderer */
   SDL_Init(SDL_INIT_EVERYTHING);
@@ -197,6 +245,8 @@ int main(int argc, char **argv) {
     while (SDL_PollEvent(&e)) {
       switch (e.type) {
         case SDL_QUIT:
+          feed_stop(&g_feeds);
+          worker_stop();
           free(ctx);
           SDL_Quit();
           return 0;
@@ -244,9 +294,13 @@ int main(int argc, char **argv) {
       }
     }
 
-    /* tick simulation */
+    /* apply feed updates */
     g_tick++;
-    data_simulate_tick(&g_book, g_tick);
+    ingest_drain(&g_ingest, &g_book, INGEST_FRAME_BUDGET);
+
+    /* top-N movers follow every tick, shown or not */
+    movers_sync(&g_movers, &g_book);
+    vega_sync(&g_vega, &g_book);
 
     /* process UI */
     process_frame(ctx);
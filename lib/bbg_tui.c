@@ -0,0 +1,51 @@
+/*
+** bbg_tui.c — Bloomberg TUI Library: widgets layered on microui
+**
+** Built with the strict project flags (unlike lib/microui.c, which is
+** upstream code); only the public mu_ API is used.
+*/
+
+#include "bbg_tui.h"
+
+/* ============================================================================
+**  Virtual-Scrolled Table
+** ============================================================================*/
+
+void bbg_table_begin(mu_Context *ctx, bbg_Table *t, const char *name,
+                     int count, int row_h)
+{
+  mu_begin_panel(ctx, name);
+  mu_Container *cnt = mu_get_current_container(ctx);
+
+  /* Content-space y of row k is k * step (layout rows add the spacing) */
+  int step = row_h + ctx->style->spacing;
+  int top  = cnt->scroll.y - ctx->style->padding;
+  int first = top > 0 ? top / step : 0;
+  int last  = (top + cnt->body.h) / step + 1;
+  if (first > count) first = count;
+  if (last > count)  last = count;
+  if (last < first)  last = first;
+
+  t->count = count;
+  t->row_h = row_h;
+  t->step  = step;
+  t->first = first;
+  t->last  = last;
+
+  /* Stand-in for rows [0, first): puts row `first` at first * step */
+  if (first > 0) {
+    mu_layout_row(ctx, 1, (int[]){ -1 }, first * step - ctx->style->spacing);
+    mu_layout_next(ctx);
+  }
+}
+
+
+void bbg_table_end(mu_Context *ctx, bbg_Table *t) {
+  /* Stand-in for rows [last, count): content height stays count rows tall */
+  int rest = t->count - t->last;
+  if (rest > 0) {
+    mu_layout_row(ctx, 1, (int[]){ -1 }, rest * t->step - ctx->style->spacing);
+    mu_layout_next(ctx);
+  }
+  mu_end_panel(ctx);
+}
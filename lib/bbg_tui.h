@@ -5,7 +5,8 @@
 ** microui's API. As the fork diverges (horizontal scroll, table widgets,
 ** keyboard nav), this becomes the canonical header.
 **
-** For now, microui.c compiles unchanged against this header via microui.h.
+** microui.c compiles unchanged against this header via microui.h; the
+** fork's own widgets live in bbg_tui.c.
 ** The mu_ prefix is retained until the Odin port, at which point we'll
 ** rename to bbg_ namespace.
 **
@@ -22,13 +23,45 @@
 /* Pull in the actual implementation header (which has our modified limits) */
 #include "microui.h"
 
+/* ============================================================================
+**  Virtual-Scrolled Table
+** ============================================================================
+**
+** A scrolling panel of `count` fixed-height rows that only lays out the
+** rows inside the viewport. bbg_table_begin() opens the panel, works out
+** [first, last) from the panel's scroll and body, and reserves the space
+** above `first` with one spacer row; bbg_table_end() reserves the space
+** below `last` and closes the panel. The content height (and so the
+** scrollbar) is that of all `count` rows, but commands are emitted only
+** for the visible ones — frame cost follows the viewport, not the book.
+**
+**   bbg_Table t;
+**   bbg_table_begin(ctx, &t, "grid", n, ROW_H);
+**   for (int k = t.first; k < t.last; k++) draw_line(ctx, k);
+**   bbg_table_end(ctx, &t);
+**
+** Each line must lay out exactly one row of height row_h, and nothing
+** else may be laid out inside the table.
+*/
+
+typedef struct {
+  int count;          /* rows in the table */
+  int row_h;
+  int step;           /* row_h + style spacing: content pitch of a row */
+  int first, last;    /* rows to draw this frame: [first, last) */
+} bbg_Table;
+
+void bbg_table_begin(mu_Context *ctx, bbg_Table *t, const char *name,
+                     int count, int row_h);
+void bbg_table_end(mu_Context *ctx, bbg_Table *t);
+
 /*
 ** Future additions for the bbg_tui fork:
 **
-** - bbg_table_begin() / bbg_table_end()     — virtual-scrolled grid widget
 ** - bbg_hscroll_panel()                      — horizontal scroll panel
 ** - bbg_kbd_nav()                            — arrow key cell navigation
 ** - bbg_column_sort()                        — click-to-sort headers
+**                                              (POMS sorts app-side: src/sort.c)
 ** - bbg_cell_edit()                          — inline cell editing
 ** - bbg_context_menu()                       — right-click menus
 */
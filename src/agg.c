@@ -0,0 +1,309 @@
+/*
+** agg.c — Masked, compensated column reductions (AVX2 + scalar)
+*/
+
+#include <stdatomic.h>
+#include "agg.h"
+#include "sel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AGG_X86 1
+#include <immintrin.h>
+#else
+#define AGG_X86 0
+#endif
+
+static _Atomic int s_force_scalar = 0;
+
+int agg_simd_active(void) {
+#if AGG_X86
+  return !atomic_load_explicit(&s_force_scalar, memory_order_relaxed) &&
+         __builtin_cpu_supports("avx2");
+#else
+  return 0;
+#endif
+}
+
+void agg_force_scalar(int on) {
+  atomic_store(&s_force_scalar, on ? 1 : 0);
+}
+
+/* Selection word k: sel[k], or "all rows" (tail-masked) when sel is NULL */
+static inline uint64_t sel_word(const uint64_t *sel, int k, int n) {
+  if (sel) return sel[k];
+  int left = n - k * 64;
+  return (left >= 64) ? ~0ull : ((1ull << left) - 1);
+}
+
+
+/* ============================================================================
+**  Scalar Path (Neumaier compensation)
+** ============================================================================*/
+
+typedef struct { double s, c; } Acc;
+
+static inline double fabs_d(double x) { return x < 0 ? -x : x; }
+
+static inline void acc_add(Acc *a, double x) {
+  double t = a->s + x;
+  if (fabs_d(a->s) >= fabs_d(x)) a->c += (a->s - t) + x;
+  else                           a->c += (x - t) + a->s;
+  a->s = t;
+}
+
+static double sum_scalar(const double *col, const uint64_t *sel, int n) {
+  Acc a = { 0, 0 };
+  int words = SEL_WORDS(n);
+  for (int k = 0; k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    while (w) {
+      acc_add(&a, col[k * 64 + __builtin_ctzll(w)]);
+      w &= w - 1;
+    }
+  }
+  return a.s + a.c;
+}
+
+static void wsum_scalar(const double *x, const double *wt, const uint64_t *sel,
+                        int n, double *num, double *den)
+{
+  Acc an = { 0, 0 }, ad = { 0, 0 };
+  int words = SEL_WORDS(n);
+  for (int k = 0; k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    while (w) {
+      int i = k * 64 + __builtin_ctzll(w);
+      acc_add(&an, x[i] * wt[i]);
+      acc_add(&ad, wt[i]);
+      w &= w - 1;
+    }
+  }
+  *num = an.s + an.c;
+  *den = ad.s + ad.c;
+}
+
+static int minmax_scalar(const double *col, const uint64_t *sel, int n,
+                         double *mn, double *mx)
+{
+  int cnt = 0;
+  double lo = 0, hi = 0;
+  int words = SEL_WORDS(n);
+  for (int k = 0; k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    while (w) {
+      double v = col[k * 64 + __builtin_ctzll(w)];
+      if (cnt == 0 || v < lo) lo = v;
+      if (cnt == 0 || v > hi) hi = v;
+      cnt++;
+      w &= w - 1;
+    }
+  }
+  if (cnt) { *mn = lo; *mx = hi; }
+  return cnt;
+}
+
+
+/* ============================================================================
+**  AVX2 Path — 4 lanes, selection nibble → lane mask via maskload
+** ============================================================================*/
+
+#if AGG_X86
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static inline __m256i lane_mask(unsigned nib) {
+  const __m256i bits = _mm256_set_epi64x(8, 4, 2, 1);
+  __m256i v = _mm256_set1_epi64x((long long)nib);
+  return _mm256_cmpeq_epi64(_mm256_and_si256(v, bits), bits);
+}
+
+/* Per-lane Neumaier step: s += x, c += lost low-order bits */
+AVX2 static inline void acc4_add(__m256d *s, __m256d *c, __m256d x) {
+  const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+  __m256d t  = _mm256_add_pd(*s, x);
+  __m256d ge = _mm256_cmp_pd(_mm256_and_pd(*s, abs_mask),
+                             _mm256_and_pd(x, abs_mask), _CMP_GE_OQ);
+  __m256d a  = _mm256_add_pd(_mm256_sub_pd(*s, t), x);
+  __m256d b  = _mm256_add_pd(_mm256_sub_pd(x, t), *s);
+  *c = _mm256_add_pd(*c, _mm256_blendv_pd(b, a, ge));
+  *s = t;
+}
+
+/* Fold 4 compensated lanes into one result, still compensated */
+AVX2 static double acc4_reduce(__m256d s, __m256d c) {
+  double ls[4], lc[4];
+  _mm256_storeu_pd(ls, s);
+  _mm256_storeu_pd(lc, c);
+  Acc a = { 0, 0 };
+  for (int i = 0; i < 4; i++) acc_add(&a, ls[i]);
+  for (int i = 0; i < 4; i++) acc_add(&a, lc[i]);
+  return a.s + a.c;
+}
+
+AVX2 static double sum_avx2(const double *col, const uint64_t *sel, int n) {
+  __m256d s = _mm256_setzero_pd(), c = _mm256_setzero_pd();
+  int words = SEL_WORDS(n);
+
+  for (int k = 0; k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    if (!w) continue;
+    const double *base = col + k * 64;
+
+    if (w == ~0ull) {
+      for (int j = 0; j < 64; j += 4) acc4_add(&s, &c, _mm256_loadu_pd(base + j));
+      continue;
+    }
+    for (int j = 0; j < 64; j += 4) {
+      unsigned nib = (unsigned)(w >> j) & 0xFu;
+      if (!nib) continue;
+      /* masked lanes read as 0.0 and never touch memory past n */
+      acc4_add(&s, &c, _mm256_maskload_pd(base + j, lane_mask(nib)));
+    }
+  }
+  return acc4_reduce(s, c);
+}
+
+AVX2 static void wsum_avx2(const double *x, const double *wt, const uint64_t *sel,
+                           int n, double *num, double *den)
+{
+  __m256d sn = _mm256_setzero_pd(), cn = _mm256_setzero_pd();
+  __m256d sd = _mm256_setzero_pd(), cd = _mm256_setzero_pd();
+  int words = SEL_WORDS(n);
+
+  for (int k = 0; k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    if (!w) continue;
+    for (int j = 0; j < 64; j += 4) {
+      unsigned nib = (unsigned)(w >> j) & 0xFu;
+      if (!nib) continue;
+      __m256i m  = lane_mask(nib);
+      __m256d xv = _mm256_maskload_pd(x  + k * 64 + j, m);
+      __m256d wv = _mm256_maskload_pd(wt + k * 64 + j, m);
+      acc4_add(&sn, &cn, _mm256_mul_pd(xv, wv));
+      acc4_add(&sd, &cd, wv);
+    }
+  }
+  *num = acc4_reduce(sn, cn);
+  *den = acc4_reduce(sd, cd);
+}
+
+AVX2 static int minmax_avx2(const double *col, const uint64_t *sel, int n,
+                            double *mn, double *mx)
+{
+  const __m256d pinf = _mm256_set1_pd(__builtin_inf());
+  const __m256d ninf = _mm256_set1_pd(-__builtin_inf());
+  __m256d lo = pinf, hi = ninf;
+  int cnt = 0, words = SEL_WORDS(n);
+
+  for (int k = 0; k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    if (!w) continue;
+    cnt += __builtin_popcountll(w);
+    for (int j = 0; j < 64; j += 4) {
+      unsigned nib = (unsigned)(w >> j) & 0xFu;
+      if (!nib) continue;
+      __m256i m = lane_mask(nib);
+      __m256d v = _mm256_maskload_pd(col + k * 64 + j, m);
+      __m256d mk = _mm256_castsi256_pd(m);
+      lo = _mm256_min_pd(lo, _mm256_blendv_pd(pinf, v, mk));
+      hi = _mm256_max_pd(hi, _mm256_blendv_pd(ninf, v, mk));
+    }
+  }
+  if (!cnt) return 0;
+
+  double l[4], h[4];
+  _mm256_storeu_pd(l, lo);
+  _mm256_storeu_pd(h, hi);
+  double rl = l[0], rh = h[0];
+  for (int i = 1; i < 4; i++) {
+    if (l[i] < rl) rl = l[i];
+    if (h[i] > rh) rh = h[i];
+  }
+  *mn = rl;
+  *mx = rh;
+  return cnt;
+}
+
+#endif
+
+
+/* ============================================================================
+**  Public Kernels
+** ============================================================================*/
+
+double agg_sum(const double *col, const uint64_t *sel, int n) {
+  if (n <= 0) return 0;
+#if AGG_X86
+  if (agg_simd_active()) return sum_avx2(col, sel, n);
+#endif
+  return sum_scalar(col, sel, n);
+}
+
+
+int64_t agg_sum_i64(const int64_t *col, const uint64_t *sel, int n) {
+  int64_t s = 0;
+  if (n <= 0) return 0;
+  if (!sel) {
+    for (int i = 0; i < n; i++) s += col[i];
+    return s;
+  }
+  /* Branchless mask-and-add: exact, and the compiler vectorizes it */
+  int words = SEL_WORDS(n);
+  for (int k = 0; k < words; k++) {
+    uint64_t w = sel[k];
+    if (!w) continue;
+    int lim = (n - k * 64 < 64) ? n - k * 64 : 64;
+    const int64_t *base = col + k * 64;
+    for (int j = 0; j < lim; j++) {
+      s += base[j] & -(int64_t)((w >> j) & 1u);
+    }
+  }
+  return s;
+}
+
+
+int agg_count(const uint64_t *sel, int n) {
+  if (n <= 0) return 0;
+  return sel ? sel_count(sel, n) : n;
+}
+
+
+double agg_mean(const double *col, const uint64_t *sel, int n) {
+  int c = agg_count(sel, n);
+  return c ? agg_sum(col, sel, n) / c : 0;
+}
+
+
+int agg_minmax(const double *col, const uint64_t *sel, int n,
+               double *mn, double *mx)
+{
+  if (n <= 0) return 0;
+#if AGG_X86
+  if (agg_simd_active()) return minmax_avx2(col, sel, n, mn, mx);
+#endif
+  return minmax_scalar(col, sel, n, mn, mx);
+}
+
+
+double agg_wavg(const double *x, const double *w, const uint64_t *sel, int n) {
+  double num = 0, den = 0;
+  if (n <= 0) return 0;
+#if AGG_X86
+  if (agg_simd_active()) wsum_avx2(x, w, sel, n, &num, &den);
+  else                   wsum_scalar(x, w, sel, n, &num, &den);
+#else
+  wsum_scalar(x, w, sel, n, &num, &den);
+#endif
+  return den != 0 ? num / den : 0;
+}
+
+
+FxPnl agg_sum_money(const BookColumns *cols, NumField f,
+                    const uint64_t *sel, int n)
+{
+#ifdef BBG_FIXED
+  return agg_sum_i64(cols->fx[f], sel, n);
+#else
+  return agg_sum(cols->f64[f], sel, n);
+#endif
+}
@@ -0,0 +1,44 @@
+/*
+** agg.h — Column Aggregation Kernels
+**
+** Masked reductions over one BookColumns column and a selection bitmap
+** (sel.h). sel == NULL means "all n rows". Every book aggregate, footer
+** and subtotal goes through here rather than an ad-hoc += loop.
+**
+** Double sums use Neumaier (improved Kahan) compensation per lane, so
+** 500k mixed-sign P&L values sum to within an ulp or two of the exact
+** result regardless of order. On x86 an AVX2 path (4 lanes, masked with
+** the selection bits) is picked at runtime; elsewhere, or when forced off,
+** the scalar path computes the same compensated result.
+*/
+
+#ifndef AGG_H
+#define AGG_H
+
+#include <stdint.h>
+#include "data.h"
+
+/* ---- Sum / count / mean ---- */
+double  agg_sum(const double *col, const uint64_t *sel, int n);
+int64_t agg_sum_i64(const int64_t *col, const uint64_t *sel, int n);
+int     agg_count(const uint64_t *sel, int n);
+double  agg_mean(const double *col, const uint64_t *sel, int n);
+
+/* ---- Min / max over selected rows. Returns the count (0 → mn/mx untouched). ---- */
+int     agg_minmax(const double *col, const uint64_t *sel, int n,
+                   double *mn, double *mx);
+
+/* ---- sum(w*x) / sum(w) over selected rows (0 if sum(w) == 0) ---- */
+double  agg_wavg(const double *x, const double *w, const uint64_t *sel, int n);
+
+/* ---- Sum of a money field in storage type (exact in BBG_FIXED builds) ---- */
+FxPnl   agg_sum_money(const BookColumns *cols, NumField f,
+                      const uint64_t *sel, int n);
+
+/* ---- Kernel selection: 1 if the AVX2 path is active ---- */
+int     agg_simd_active(void);
+
+/* ---- Force the scalar path (benchmarks / A-B checks) ---- */
+void    agg_force_scalar(int on);
+
+#endif
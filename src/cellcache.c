@@ -0,0 +1,94 @@
+/*
+** cellcache.c — Formatted grid cells, cached per position and column
+*/
+
+#include <string.h>
+#include "cellcache.h"
+#include "fmt.h"
+
+static uint64_t bits_f64(double v) {
+  uint64_t u;
+  memcpy(&u, &v, sizeof(u));
+  return u;
+}
+
+void cell_cache_sync(CellCache *cc, const PositionBook *book, mu_Font font) {
+  if (cc->book != book || cc->struct_epoch != book->struct_epoch) {
+    memset(cc->cells, 0, sizeof(cc->cells));
+    cc->book         = book;
+    cc->struct_epoch = book->struct_epoch;
+  } else if (cc->font != font) {
+    for (int r = 0; r < MAX_POSITIONS; r++) {
+      for (int c = 0; c < CELL_COLS; c++) cc->cells[r][c].w = -1;
+    }
+  }
+  cc->font = font;
+}
+
+/* Entry for (row, col) if it holds (key, fmt), else NULL with *e set to refill */
+static CellEntry* probe(CellCache *cc, int row, int col, uint64_t key, uint16_t fmt,
+                        CellEntry **e)
+{
+  *e = &cc->cells[row][col];
+  return ((*e)->fmt == fmt && (*e)->key == key) ? *e : NULL;
+}
+
+/* Store a freshly formatted text; the width survives if the text didn't change */
+static CellEntry* fill(CellCache *cc, CellEntry *e, uint64_t key, uint16_t fmt,
+                       const char *s, int len)
+{
+  cc->formats++;
+  if (e->fmt == 0 || e->len != len || memcmp(e->s, s, (size_t)len) != 0) {
+    memcpy(e->s, s, (size_t)len + 1);
+    e->len = (uint8_t)len;
+    e->w   = -1;
+  }
+  e->key = key;
+  e->fmt = fmt;
+  return e;
+}
+
+static uint16_t fmt_id(int decimals, int flags) {
+  return (uint16_t)((decimals & 31) | flags << 5 | 1 << 15);   /* never 0 */
+}
+
+
+CellEntry* cell_f64(CellCache *cc, int row, int col, double v, int decimals, int flags) {
+  CellEntry *e, *hit;
+  uint64_t   key = bits_f64(v);
+  uint16_t   fmt = fmt_id(decimals, flags);
+  if ((hit = probe(cc, row, col, key, fmt, &e)) != NULL) return hit;
+
+  char buf[CELL_STR];
+  int  len = fmt_f64(buf, (int)sizeof(buf), v, decimals, flags);
+  return fill(cc, e, key, fmt, buf, len);
+}
+
+
+/* ============================================================================
+**  Book Storage Types
+** ============================================================================*/
+
+#ifdef BBG_FIXED
+#define RAW_KEY(v) ((uint64_t)(v))
+#else
+#define RAW_KEY(v) bits_f64(v)
+#endif
+
+#define CELL_FX(name, type, fmt_fn)                                           \
+  CellEntry* name(CellCache *cc, int row, int col, type v, int decimals,     \
+                  int flags)                                                  \
+  {                                                                           \
+    CellEntry *e, *hit;                                                       \
+    uint64_t   key = RAW_KEY(v);                                              \
+    uint16_t   fmt = fmt_id(decimals, flags);                                 \
+    if ((hit = probe(cc, row, col, key, fmt, &e)) != NULL) return hit;       \
+                                                                              \
+    char buf[CELL_STR];                                                       \
+    int  len = fmt_fn(buf, (int)sizeof(buf), v, decimals, flags);             \
+    return fill(cc, e, key, fmt, buf, len);                                   \
+  }
+
+CELL_FX(cell_price,    FxPrice,    fmt_price)
+CELL_FX(cell_notional, FxNotional, fmt_notional)
+CELL_FX(cell_pnl,      FxPnl,      fmt_pnl)
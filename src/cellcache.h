@@ -0,0 +1,55 @@
+/*
+** cellcache.h — Formatted Grid Cells, Cached per Position and Column
+**
+** Most grid cells read the same from one frame to the next. Each entry
+** keeps the string a numeric cell was formatted to, the raw value and
+** format (decimals | flags) it came from, and its pixel width once
+** measured. A lookup whose value and format match returns the entry as
+** is — no formatting, no measuring. A changed value is re-formatted; if
+** the text is unchanged (a move below the displayed precision) the
+** measured width is kept.
+**
+** Keys are the raw storage bits (the double's bits, or the int64 in
+** BBG_FIXED builds), so any change in value is seen. Rows are book rows;
+** the cache empties when the book or its rows change (cell_cache_sync),
+** and widths are dropped when the font does.
+*/
+
+#ifndef CELLCACHE_H
+#define CELLCACHE_H
+
+#include <stdint.h>
+#include "bbg_tui.h"
+#include "data.h"
+
+#define CELL_COLS 16                /* grid columns per position */
+#define CELL_STR  26                /* longest cell text + NUL */
+
+typedef struct {
+  uint64_t key;                     /* raw value bits it was formatted from */
+  uint16_t fmt;                     /* decimals | flags << 5; 0 = empty */
+  int16_t  w;                       /* pixel width, -1 until measured */
+  uint8_t  len;
+  char     s[CELL_STR];
+} CellEntry;
+
+typedef struct {
+  CellEntry   cells[MAX_POSITIONS][CELL_COLS];
+  const PositionBook *book;
+  unsigned    struct_epoch;
+  mu_Font     font;
+  unsigned    formats;              /* misses: strings actually formatted */
+} CellCache;
+
+/* ---- Once per frame: empty on a new book / rows, drop widths on a new font ---- */
+void cell_cache_sync(CellCache *cc, const PositionBook *book, mu_Font font);
+
+/* ---- Cell (row, col) showing v; formats only if value or format changed ---- */
+CellEntry* cell_f64(CellCache *cc, int row, int col, double v, int decimals, int flags);
+
+/* ---- Book storage types (fmt_price / fmt_notional / fmt_pnl) ---- */
+CellEntry* cell_price(CellCache *cc, int row, int col, FxPrice v, int decimals, int flags);
+CellEntry* cell_notional(CellCache *cc, int row, int col, FxNotional v, int decimals, int flags);
+CellEntry* cell_pnl(CellCache *cc, int row, int col, FxPnl v, int decimals, int flags);
+
+#endif
@@ -1,76 +1,164 @@
 /*
-** data.c — Position data and market simulation
+** data.c — Position data and book mutation
 */
 
-#include <stdlib.h>
 #include <string.h>
 #include "data.h"
 
+/* P&L in thousands per 1MM notional per price point (1% of par). */
+#define PNL_PER_POINT 10.0
+
+/* Below this (in MM) a position is treated as flat. */
+#define FLAT_EPS 1e-9
+
+static double fabs_d(double x) { return x < 0 ? -x : x; }
+
+static int is_open(const Position *p) {
+  return fabs_d(FX_NOTIONAL_D(p->notional)) > FLAT_EPS;
+}
+
+static int is_priced(const Position *p) {
+  return FX_PRICE_D(p->mkt_price) > 0.01;
+}
+
+/* Totals are maintained by delta: every mutation removes the row's
+   contribution (sign -1), edits the row, then adds it back (sign +1).
+   In BBG_FIXED builds this is exact integer arithmetic. */
+static void totals_add(BookTotals *t, const Position *p, int sign) {
+  t->notional       += sign * p->notional;
+  t->pnl_total      += sign * p->pnl_total;
+  t->pnl_day        += sign * p->pnl_day;
+  t->pnl_realized   += sign * p->pnl_realized;
+  t->pnl_unrealized += sign * data_pnl_unrealized(p);
+  t->n_open         += sign * is_open(p);
+}
+
+/* Split dv01 between the ladder tenors either side of years */
+static void ladder_spread(float *kr, double dv01, float years) {
+  memset(kr, 0, sizeof(float) * LADDER_BUCKETS);
+  if (years <= LADDER_YEARS[0]) {
+    kr[0] = (float)dv01;
+    return;
+  }
+  for (int b = 1; b < LADDER_BUCKETS; b++) {
+    if (years <= LADDER_YEARS[b]) {
+      double w = (double)((years - LADDER_YEARS[b - 1]) / (LADDER_YEARS[b] - LADDER_YEARS[b - 1]));
+      kr[b - 1] = (float)(dv01 * (1 - w));
+      kr[b]     = (float)(dv01 * w);
+      return;
+    }
+  }
+  kr[LADDER_BUCKETS - 1] = (float)dv01;
+}
+
+/* Refresh row idx in the column mirror. Called after every row edit. */
+static void cols_sync(PositionBook *book, int idx) {
+  const Position *p = &book->items[idx];
+  book->log.rows[book->value_epoch % BOOK_LOG_LEN] = (uint16_t)idx;
+  book->value_epoch++;
+  for (int f = 0; f < FIELD_COUNT; f++) {
+    book->cols.f64[f][idx] = data_field(p, (NumField)f);
+  }
+  ladder_spread(book->ladder.dv01[idx], p->dv01, book->ladder.years[idx]);
+#ifdef BBG_FIXED
+  book->cols.fx[FIELD_NOTIONAL][idx]     = p->notional;
+  book->cols.fx[FIELD_AVG_PRICE][idx]    = p->avg_price;
+  book->cols.fx[FIELD_MKT_PRICE][idx]    = p->mkt_price;
+  book->cols.fx[FIELD_PNL_TOTAL][idx]    = p->pnl_total;
+  book->cols.fx[FIELD_PNL_DAY][idx]      = p->pnl_day;
+  book->cols.fx[FIELD_PNL_REALIZED][idx] = p->pnl_realized;
+#endif
+}
+
+/* Id of name in dict, adding it on first sight */
+static uint8_t intern(NameDict *d, const char *name) {
+  for (int i = 0; i < d->count; i++) {
+    if (d->names[i] == name || strcmp(d->names[i], name) == 0) return (uint8_t)i;
+  }
+  d->names[d->count] = name;
+  return (uint8_t)d->count++;
+}
+
+/* Fill the categorical columns and category bitmaps of a newly added row */
+static void cols_add_row(PositionBook *book, int idx) {
+  const Position *p = &book->items[idx];
+  book->cols.asset[idx] = (uint8_t)p->asset_class;
+  book->cols.desk[idx]  = intern(&book->desks, p->desk);
+  book->cols.book[idx]  = intern(&book->books, p->book);
+  book->cols.ccy[idx]   = intern(&book->ccys,  p->ccy);
+  book->ladder.years[idx] = (p->expiry > 0) ? p->expiry + p->tenor
+                                            : data_maturity_years(p->instrument);
+  sel_set(book->sets.asset[p->asset_class],      idx);
+  sel_set(book->sets.desk[book->cols.desk[idx]], idx);
+  sel_set(book->sets.book[book->cols.book[idx]], idx);
+}
+
 void data_init(PositionBook *book) {
   memset(book, 0, sizeof(*book));
 
-  struct {
+  static const struct {
     const char *inst; const char *cusip; AssetClass ac;
-    const char *book; const char *desk;
+    const char *book; const char *desk; const char *ccy;
     double notl, avg, mkt, pnl, pnl_d, dv01, cs01;
     double delta, gamma, vega, theta;
     int stale;
+    double expiry, tenor;      /* swaptions only */
   } seed[] = {
     /* ---- Rates Flow / US Rates ---- */
-    { "UST 2Y 4.25 03/27",   "91282CKL8",    ASSET_GOVT_BOND, "Rates Flow", "US Rates",
-       150, 99.875, 99.920,  67.5,  12.3, 2850, 0,  0.98, 0.001, 0, -0.45, 0 },
-    { "UST 5Y 4.00 02/30",   "91282CKM6",    ASSET_GOVT_BOND, "Rates Flow", "US Rates",
-      -75, 98.500, 98.125, -28.1, -15.7, 3520, 0, -0.95, 0.003, 0, -1.12, 0 },
-    { "UST 10Y 3.875 11/34",  "91282CKN4",   ASSET_GOVT_BOND, "Rates Flow", "US Rates",
-       200, 97.250, 97.750, 100.0,  35.2, 8750, 0,  0.92, 0.008, 0, -2.80, 0 },
-    { "UST 30Y 4.25 05/54",   "91282CKP9",   ASSET_GOVT_BOND, "Rates Flow", "US Rates",
-        50, 96.125, 95.875, -12.5,  -8.1, 15200, 0, 0.88, 0.022, 0, -5.10, 1 },
+    { "UST 2Y 4.25 03/27",   "91282CKL8",    ASSET_GOVT_BOND, "Rates Flow", "US Rates", "USD",
+       150, 99.875, 99.920,  67.5,  12.3, 2850, 0,  0.98, 0.001, 0, -0.45, 0, 0, 0 },
+    { "UST 5Y 4.00 02/30",   "91282CKM6",    ASSET_GOVT_BOND, "Rates Flow", "US Rates", "USD",
+      -75, 98.500, 98.125, -28.1, -15.7, 3520, 0, -0.95, 0.003, 0, -1.12, 0, 0, 0 },
+    { "UST 10Y 3.875 11/34",  "91282CKN4",   ASSET_GOVT_BOND, "Rates Flow", "US Rates", "USD",
+       200, 97.250, 97.750, 100.0,  35.2, 8750, 0,  0.92, 0.008, 0, -2.80, 0, 0, 0 },
+    { "UST 30Y 4.25 05/54",   "91282CKP9",   ASSET_GOVT_BOND, "Rates Flow", "US Rates", "USD",
+        50, 96.125, 95.875, -12.5,  -8.1, 15200, 0, 0.88, 0.022, 0, -5.10, 1, 0, 0 },
     /* ---- Rates Flow / EUR Rates ---- */
-    { "DBR 2Y 2.80 12/26",   "DE000BU2Z023", ASSET_GOVT_BOND, "Rates Flow", "EUR Rates",
-       100, 100.125, 100.250, 12.5,   3.2, 1920, 0,  0.99, 0.001, 0, -0.22, 0 },
-    { "DBR 10Y 2.50 08/33",  "DE000BU2Z031", ASSET_GOVT_BOND, "Rates Flow", "EUR Rates",
-      -120, 98.750, 99.125, -45.0,  -9.4, 7800, 0, -0.93, 0.007, 0, -2.40, 0 },
-    { "OAT 10Y 3.00 05/34",  "FR0014007L89", ASSET_GOVT_BOND, "Rates Flow", "EUR Rates",
-        80, 99.000, 98.500, -40.0,  -5.6, 7200, 120, 0.91, 0.006, 0, -2.10, 0 },
-    { "GILT 10Y 4.50 09/34",  "GB00BMBL1F74", ASSET_GOVT_BOND, "Rates Flow", "GBP Rates",
-        60, 101.250, 101.500, 15.0,   4.8, 7100, 0,  0.93, 0.006, 0, -2.30, 0 },
+    { "DBR 2Y 2.80 12/26",   "DE000BU2Z023", ASSET_GOVT_BOND, "Rates Flow", "EUR Rates", "EUR",
+       100, 100.125, 100.250, 12.5,   3.2, 1920, 0,  0.99, 0.001, 0, -0.22, 0, 0, 0 },
+    { "DBR 10Y 2.50 08/33",  "DE000BU2Z031", ASSET_GOVT_BOND, "Rates Flow", "EUR Rates", "EUR",
+      -120, 98.750, 99.125, -45.0,  -9.4, 7800, 0, -0.93, 0.007, 0, -2.40, 0, 0, 0 },
+    { "OAT 10Y 3.00 05/34",  "FR0014007L89", ASSET_GOVT_BOND, "Rates Flow", "EUR Rates", "EUR",
+        80, 99.000, 98.500, -40.0,  -5.6, 7200, 120, 0.91, 0.006, 0, -2.10, 0, 0, 0 },
+    { "GILT 10Y 4.50 09/34",  "GB00BMBL1F74", ASSET_GOVT_BOND, "Rates Flow", "GBP Rates", "GBP",
+        60, 101.250, 101.500, 15.0,   4.8, 7100, 0,  0.93, 0.006, 0, -2.30, 0, 0, 0 },
     /* ---- Swaps ---- */
-    { "IRS USD 2Y vs 3M",    "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps",
-       300, 4.450, 4.420, 90.0,   7.5, 5800, 0, 0, 0, 0, -0.80, 0 },
-    { "IRS USD 5Y vs 3M",    "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps",
-       500, 4.250, 4.180, 350.0,  22.1, 22100, 0, 0, 0, 0, -3.20, 0 },
-    { "IRS USD 10Y vs 3M",   "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps",
-      -250, 4.050, 4.120, -175.0, -18.5, 23500, 0, 0, 0, 0, -6.80, 0 },
-    { "IRS USD 30Y vs 3M",   "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps",
-       100, 3.950, 3.980, -30.0,  -2.1, 28000, 0, 0, 0, 0, -9.50, 0 },
-    { "IRS EUR 5Y vs 6M",    "N/A",          ASSET_IRS,       "Swaps",      "EUR Swaps",
-       300, 2.850, 2.780, 210.0,  15.4, 14200, 0, 0, 0, 0, -2.10, 0 },
-    { "IRS EUR 10Y vs 6M",   "N/A",          ASSET_IRS,       "Swaps",      "EUR Swaps",
-       150, 2.750, 2.810, -90.0,  -7.2, 14800, 0, 0, 0, 0, -4.50, 1 },
-    { "IRS GBP 5Y vs SONIA", "N/A",          ASSET_IRS,       "Swaps",      "GBP Swaps",
-       200, 4.100, 4.050, 100.0,   8.9, 10500, 0, 0, 0, 0, -1.80, 0 },
+    { "IRS USD 2Y vs 3M",    "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps", "USD",
+       300, 4.450, 4.420, 90.0,   7.5, 5800, 0, 0, 0, 0, -0.80, 0, 0, 0 },
+    { "IRS USD 5Y vs 3M",    "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps", "USD",
+       500, 4.250, 4.180, 350.0,  22.1, 22100, 0, 0, 0, 0, -3.20, 0, 0, 0 },
+    { "IRS USD 10Y vs 3M",   "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps", "USD",
+      -250, 4.050, 4.120, -175.0, -18.5, 23500, 0, 0, 0, 0, -6.80, 0, 0, 0 },
+    { "IRS USD 30Y vs 3M",   "N/A",          ASSET_IRS,       "Swaps",      "USD Swaps", "USD",
+       100, 3.950, 3.980, -30.0,  -2.1, 28000, 0, 0, 0, 0, -9.50, 0, 0, 0 },
+    { "IRS EUR 5Y vs 6M",    "N/A",          ASSET_IRS,       "Swaps",      "EUR Swaps", "EUR",
+       300, 2.850, 2.780, 210.0,  15.4, 14200, 0, 0, 0, 0, -2.10, 0, 0, 0 },
+    { "IRS EUR 10Y vs 6M",   "N/A",          ASSET_IRS,       "Swaps",      "EUR Swaps", "EUR",
+       150, 2.750, 2.810, -90.0,  -7.2, 14800, 0, 0, 0, 0, -4.50, 1, 0, 0 },
+    { "IRS GBP 5Y vs SONIA", "N/A",          ASSET_IRS,       "Swaps",      "GBP Swaps", "GBP",
+       200, 4.100, 4.050, 100.0,   8.9, 10500, 0, 0, 0, 0, -1.80, 0, 0, 0 },
     /* ---- Futures ---- */
-    { "TU  H6 (2Y Fut)",     "N/A",          ASSET_FUTURES,   "Futures",    "US Rates",
-       400, 103.140, 103.200, 24.0,   8.5, 1650, 0,  0.99, 0, 0, -0.10, 0 },
-    { "FV  H6 (5Y Fut)",     "N/A",          ASSET_FUTURES,   "Futures",    "US Rates",
-      -300, 108.250, 108.125, -37.5, -6.2, 4200, 0, -0.97, 0, 0, -0.35, 0 },
-    { "TY  H6 (10Y Fut)",    "N/A",          ASSET_FUTURES,   "Futures",    "US Rates",
-       200, 111.500, 112.000, 100.0, 28.3, 7800, 0,  0.94, 0, 0, -0.90, 0 },
-    { "US  H6 (Bond Fut)",   "N/A",          ASSET_FUTURES,   "Futures",    "US Rates",
-       -50, 118.750, 118.500, 12.5,   4.1, 13200, 0, -0.90, 0, 0, -1.50, 0 },
-    { "RX  H6 (Bund Fut)",   "N/A",          ASSET_FUTURES,   "Futures",    "EUR Rates",
-       150, 131.250, 131.500, 37.5,  11.2, 7500, 0,  0.93, 0, 0, -0.70, 0 },
-    { "OAT H6 (OAT Fut)",   "N/A",          ASSET_FUTURES,   "Futures",    "EUR Rates",
-        80, 126.500, 126.750, 20.0,   6.4, 6800, 0,  0.92, 0, 0, -0.60, 0 },
+    { "TU  H6 (2Y Fut)",     "N/A",          ASSET_FUTURES,   "Futures",    "US Rates", "USD",
+       400, 103.140, 103.200, 24.0,   8.5, 1650, 0,  0.99, 0, 0, -0.10, 0, 0, 0 },
+    { "FV  H6 (5Y Fut)",     "N/A",          ASSET_FUTURES,   "Futures",    "US Rates", "USD",
+      -300, 108.250, 108.125, -37.5, -6.2, 4200, 0, -0.97, 0, 0, -0.35, 0, 0, 0 },
+    { "TY  H6 (10Y Fut)",    "N/A",          ASSET_FUTURES,   "Futures",    "US Rates", "USD",
+       200, 111.500, 112.000, 100.0, 28.3, 7800, 0,  0.94, 0, 0, -0.90, 0, 0, 0 },
+    { "US  H6 (Bond Fut)",   "N/A",          ASSET_FUTURES,   "Futures",    "US Rates", "USD",
+       -50, 118.750, 118.500, 12.5,   4.1, 13200, 0, -0.90, 0, 0, -1.50, 0, 0, 0 },
+    { "RX  H6 (Bund Fut)",   "N/A",          ASSET_FUTURES,   "Futures",    "EUR Rates", "EUR",
+       150, 131.250, 131.500, 37.5,  11.2, 7500, 0,  0.93, 0, 0, -0.70, 0, 0, 0 },
+    { "OAT H6 (OAT Fut)",   "N/A",          ASSET_FUTURES,   "Futures",    "EUR Rates", "EUR",
+        80, 126.500, 126.750, 20.0,   6.4, 6800, 0,  0.92, 0, 0, -0.60, 0, 0, 0 },
     /* ---- Vol Desk / Swaptions ---- */
-    { "USD 1Yx5Y Payer",     "N/A",          ASSET_SWAPTION,  "Vol Desk",   "USD Vol",
-       100, 0, 0,  45.0,  5.8, 4200, 0,  0.52, 0.08, 285.0, -12.5, 0 },
-    { "USD 5Yx10Y Recv",     "N/A",          ASSET_SWAPTION,  "Vol Desk",   "USD Vol",
-       -80, 0, 0, -22.0, -3.1, 8900, 0, -0.48, 0.05, 420.0, -18.2, 0 },
-    { "EUR 1Yx10Y Payer",    "N/A",          ASSET_SWAPTION,  "Vol Desk",   "EUR Vol",
-        60, 0, 0,  18.5,  2.4, 5600, 0,  0.55, 0.06, 310.0, -14.8, 1 },
-    { "USD 3Mx10Y Straddle", "N/A",          ASSET_SWAPTION,  "Vol Desk",   "USD Vol",
-       120, 0, 0,  32.0,  4.2, 6200, 0,  0.02, 0.12, 550.0, -22.0, 0 },
+    { "USD 1Yx5Y Payer",     "N/A",          ASSET_SWAPTION,  "Vol Desk",   "USD Vol", "USD",
+       100, 0, 0,  45.0,  5.8, 4200, 0,  0.52, 0.08, 285.0, -12.5, 0, 1, 5 },
+    { "USD 5Yx10Y Recv",     "N/A",          ASSET_SWAPTION,  "Vol Desk",   "USD Vol", "USD",
+       -80, 0, 0, -22.0, -3.1, 8900, 0, -0.48, 0.05, 420.0, -18.2, 0, 5, 10 },
+    { "EUR 1Yx10Y Payer",    "N/A",          ASSET_SWAPTION,  "Vol Desk",   "EUR Vol", "EUR",
+        60, 0, 0,  18.5,  2.4, 5600, 0,  0.55, 0.06, 310.0, -14.8, 1, 1, 10 },
+    { "USD 3Mx10Y Straddle", "N/A",          ASSET_SWAPTION,  "Vol Desk",   "USD Vol", "USD",
+       120, 0, 0,  32.0,  4.2, 6200, 0,  0.02, 0.12, 550.0, -22.0, 0, 0.25, 10 },
   };
 
   int n = sizeof(seed) / sizeof(seed[0]);
@@ -83,11 +171,14 @@ void data_init(PositionBook *book) {
       .asset_class = seed[i].ac,
       .book        = seed[i].book,
       .desk        = seed[i].desk,
-      .notional    = seed[i].notl,
-      .avg_price   = seed[i].avg,
-      .mkt_price   = seed[i].mkt,
-      .pnl_total   = seed[i].pnl,
-      .pnl_day     = seed[i].pnl_d,
+      .ccy         = seed[i].ccy,
+      .expiry      = (float)seed[i].expiry,
+      .tenor       = (float)seed[i].tenor,
+      .notional    = FX_NOTIONAL(seed[i].notl),
+      .avg_price   = FX_PRICE(seed[i].avg),
+      .mkt_price   = FX_PRICE(seed[i].mkt),
+      .pnl_total   = FX_PNL(seed[i].pnl),
+      .pnl_day     = FX_PNL(seed[i].pnl_d),
       .dv01        = seed[i].dv01,
       .cs01        = seed[i].cs01,
       .delta       = seed[i].delta,
@@ -96,22 +187,189 @@ void data_init(PositionBook *book) {
       .theta       = seed[i].theta,
       .stale       = seed[i].stale,
     };
+    totals_add(&book->totals, &book->items[i], +1);
+    cols_add_row(book, i);
+    cols_sync(book, i);
   }
 }
 
 
-void data_simulate_tick(PositionBook *book, int tick) {
-  if (tick % 15 != 0) return;  /* update every ~15 frames (~250ms at 60fps) */
+/* ============================================================================
+**  Book Mutation
+** ============================================================================*/
+
+void data_mark_price(PositionBook *book, int idx, double px) {
+  if (idx < 0 || idx >= book->count) return;
+  Position *p = &book->items[idx];
+  if (!is_priced(p) || px <= 0.01) return;  /* unpriced (swaptions) */
+
+  FxPrice npx  = FX_PRICE(px);
+  FxPnl   move = FX_PNL(FX_PRICE_D(npx - p->mkt_price) *
+                        FX_NOTIONAL_D(p->notional) * PNL_PER_POINT);
+  totals_add(&book->totals, p, -1);
+  p->mkt_price  = npx;
+  p->pnl_day   += move;
+  p->pnl_total += move;
+  totals_add(&book->totals, p, +1);
+  cols_sync(book, idx);
+}
+
+
+void data_accrue_pnl(PositionBook *book, int idx, double pnl) {
+  if (idx < 0 || idx >= book->count) return;
+  Position *p = &book->items[idx];
+  FxPnl d = FX_PNL(pnl);
+  p->pnl_day   += d;
+  p->pnl_total += d;
+  book->totals.pnl_day   += d;
+  book->totals.pnl_total += d;
+  book->totals.pnl_carry += d;
+  cols_sync(book, idx);
+}
+
+
+void data_set_risk(PositionBook *book, int idx, const PositionRisk *risk) {
+  if (idx < 0 || idx >= book->count) return;
+  Position *p = &book->items[idx];
+  p->dv01  = risk->dv01;
+  p->cs01  = risk->cs01;
+  p->delta = risk->delta;
+  p->gamma = risk->gamma;
+  p->vega  = risk->vega;
+  p->theta = risk->theta;
+  cols_sync(book, idx);
+}
 
-  for (int i = 0; i < book->count; i++) {
-    Position *p = &book->items[i];
-    double jitter = ((rand() % 2001) - 1000) / 100000.0;
-    if (p->mkt_price > 0.01) {
-      p->mkt_price += jitter;
-      p->pnl_day   += jitter * p->notional * 10.0;
-      p->pnl_total += jitter * p->notional * 10.0;
+
+void data_apply_fill(PositionBook *book, int idx, double qty, double px) {
+  if (idx < 0 || idx >= book->count) return;
+  if (fabs_d(qty) <= FLAT_EPS) return;
+  if (!(px > 0)) return;                    /* no price (or nan): not a fill */
+  Position *p = &book->items[idx];
+
+  double n0   = FX_NOTIONAL_D(p->notional);
+  double a0   = FX_PRICE_D(p->avg_price);
+  double mark = is_priced(p) ? FX_PRICE_D(p->mkt_price) : px;  /* unpriced: fill is the mark */
+
+  totals_add(&book->totals, p, -1);
+
+  if (!is_open(p) || (n0 > 0) == (qty > 0)) {
+    /* Open or extend: size-weighted average */
+    double an = fabs_d(n0), aq = fabs_d(qty);
+    p->avg_price = FX_PRICE((an * a0 + aq * px) / (an + aq));
+    p->notional += FX_NOTIONAL(qty);
+  } else {
+    /* Reduce, close, or flip */
+    double closed = fabs_d(qty) < fabs_d(n0) ? fabs_d(qty) : fabs_d(n0);
+    double side   = (n0 > 0) ? 1.0 : -1.0;
+    p->pnl_realized += FX_PNL(closed * (px - a0) * side * PNL_PER_POINT);
+    p->notional     += FX_NOTIONAL(qty);
+
+    if (!is_open(p)) {
+      p->notional  = 0;
+      p->avg_price = 0;
+    } else if ((p->notional > 0) != (n0 > 0)) {
+      p->avg_price = FX_PRICE(px);   /* flipped: remainder opens at the fill */
+    }
+  }
+
+  /* Trading off the mark is immediate P&L; realized/unrealized just
+     re-split the rest. */
+  FxPnl edge = FX_PNL(qty * (mark - px) * PNL_PER_POINT);
+  p->pnl_total += edge;
+  p->pnl_day   += edge;
+
+  totals_add(&book->totals, p, +1);
+  cols_sync(book, idx);
+}
+
+
+int data_open_position(PositionBook *book, const Position *tmpl) {
+  if (book->count >= MAX_POSITIONS) return -1;
+  int idx = book->count++;
+  book->items[idx] = *tmpl;
+  book->items[idx].notional     = 0;
+  book->items[idx].avg_price    = 0;
+  book->items[idx].pnl_total    = 0;
+  book->items[idx].pnl_day      = 0;
+  book->items[idx].pnl_realized = 0;
+  book->struct_epoch++;
+  totals_add(&book->totals, &book->items[idx], +1);
+  cols_add_row(book, idx);
+  cols_sync(book, idx);
+  return idx;
+}
+
+
+FxPnl data_pnl_unrealized(const Position *p) {
+  if (!is_priced(p) || FX_PRICE_D(p->avg_price) <= 0.001) return 0;
+  return FX_PNL(FX_PRICE_D(p->mkt_price - p->avg_price) *
+                FX_NOTIONAL_D(p->notional) * PNL_PER_POINT);
+}
+
+
+double data_field(const Position *p, NumField f) {
+  switch (f) {
+    case FIELD_NOTIONAL:     return FX_NOTIONAL_D(p->notional);
+    case FIELD_AVG_PRICE:    return FX_PRICE_D(p->avg_price);
+    case FIELD_MKT_PRICE:    return FX_PRICE_D(p->mkt_price);
+    case FIELD_PNL_TOTAL:    return FX_PNL_D(p->pnl_total);
+    case FIELD_PNL_DAY:      return FX_PNL_D(p->pnl_day);
+    case FIELD_PNL_REALIZED: return FX_PNL_D(p->pnl_realized);
+    case FIELD_DV01:         return p->dv01;
+    case FIELD_CS01:         return p->cs01;
+    case FIELD_DELTA:        return p->delta;
+    case FIELD_GAMMA:        return p->gamma;
+    case FIELD_VEGA:         return p->vega;
+    case FIELD_THETA:        return p->theta;
+    default:                 return 0;
+  }
+}
+
+
+/* Tenor token at s ("10Y", "3M") in years, advancing *end past it; 0 if none */
+static float tenor_at(const char *s, const char **end) {
+  float n = 0;
+  const char *q = s;
+  while (*q >= '0' && *q <= '9') n = n * 10 + (float)(*q++ - '0');
+  if (q == s || (*q != 'Y' && *q != 'M')) return 0;
+  *end = q + 1;
+  return *q == 'Y' ? n : n / 12;
+}
+
+float data_maturity_years(const char *instrument) {
+  for (const char *s = instrument; *s; s++) {
+    if (s != instrument && ((s[-1] >= '0' && s[-1] <= '9') || s[-1] == '.')) continue;
+    const char *end;
+    float years = tenor_at(s, &end);
+    if (years <= 0) continue;
+    if (*end == 'x') {
+      float tenor = tenor_at(end + 1, &end);
+      years += tenor;
     }
-    p->pnl_day   += p->theta * 0.001;
-    p->pnl_total += p->theta * 0.001;
+    return years;
   }
+  return 10;
+}
+
+
+const char *data_book_short(const char *book) {
+  if (strcmp(book, "Rates Flow") == 0) return "FLOW";
+  if (strcmp(book, "Swaps")      == 0) return "SWAP";
+  if (strcmp(book, "Futures")    == 0) return "FUT";
+  if (strcmp(book, "Vol Desk")   == 0) return "VOL";
+  return book;
+}
+
+
+const char *data_desk_short(const char *desk) {
+  if (strcmp(desk, "US Rates")  == 0) return "USR";
+  if (strcmp(desk, "EUR Rates") == 0) return "EUR";
+  if (strcmp(desk, "GBP Rates") == 0) return "GBP";
+  if (strcmp(desk, "USD Swaps") == 0) return "USDSW";
+  if (strcmp(desk, "EUR Swaps") == 0) return "EURSW";
+  if (strcmp(desk, "GBP Swaps") == 0) return "GBPSW";
+  if (strcmp(desk, "USD Vol")   == 0) return "USDVL";
+  if (strcmp(desk, "EUR Vol")   == 0) return "EURVL";
+  return desk;
 }
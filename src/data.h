@@ -8,6 +8,10 @@
 #ifndef DATA_H
 #define DATA_H
 
+#include <stdint.h>
+#include "fixed.h"
+#include "sel.h"
+
 #define MAX_POSITIONS 128
 
 /* ---- Asset Classification ---- */
@@ -32,11 +36,15 @@ typedef struct {
   AssetClass  asset_class;
   const char *book;
   const char *desk;
-  double      notional;        /* millions                */
-  double      avg_price;
-  double      mkt_price;
-  double      pnl_total;       /* total P&L in thousands  */
-  double      pnl_day;         /* day P&L in thousands    */
+  const char *ccy;             /* ISO currency, "USD"     */
+  float       expiry;          /* swaptions: option expiry, years (else 0) */
+  float       tenor;           /* swaptions: underlying swap tenor, years  */
+  FxNotional  notional;        /* millions                */
+  FxPrice     avg_price;
+  FxPrice     mkt_price;
+  FxPnl       pnl_total;       /* total P&L in thousands  */
+  FxPnl       pnl_day;         /* day P&L in thousands    */
+  FxPnl       pnl_realized;    /* realized P&L (K) from closing fills */
   double      dv01;
   double      cs01;
   double      delta;
@@ -46,16 +54,190 @@ typedef struct {
   int         stale;           /* stale price flag        */
 } Position;
 
+/* ---- Risk sensitivities as published by the risk engine ---- */
+typedef struct {
+  double dv01;
+  double cs01;
+  double delta;
+  double gamma;
+  double vega;
+  double theta;
+} PositionRisk;
+
+/* ---- Numeric fields, in column order (money fields first) ---- */
+typedef enum {
+  FIELD_NOTIONAL,
+  FIELD_AVG_PRICE,
+  FIELD_MKT_PRICE,
+  FIELD_PNL_TOTAL,
+  FIELD_PNL_DAY,
+  FIELD_PNL_REALIZED,
+  FIELD_DV01,
+  FIELD_CS01,
+  FIELD_DELTA,
+  FIELD_GAMMA,
+  FIELD_VEGA,
+  FIELD_THETA,
+  FIELD_COUNT
+} NumField;
+
+#define FIELD_MONEY_COUNT (FIELD_PNL_REALIZED + 1)
+
+/*
+** Columnar mirror of the numeric Position fields. The data_* mutation API
+** keeps it in sync row by row, so aggregation kernels (agg.h) scan one
+** field contiguously instead of striding across the AoS items.
+*/
+typedef struct {
+  double  f64[FIELD_COUNT][MAX_POSITIONS];        /* every field as double */
+#ifdef BBG_FIXED
+  int64_t fx[FIELD_MONEY_COUNT][MAX_POSITIONS];   /* exact money storage   */
+#endif
+  uint8_t asset[MAX_POSITIONS];                   /* AssetClass            */
+  uint8_t desk[MAX_POSITIONS];                    /* id in PositionBook.desks */
+  uint8_t book[MAX_POSITIONS];                    /* id in PositionBook.books */
+  uint8_t ccy[MAX_POSITIONS];                     /* id in PositionBook.ccys  */
+} BookColumns;
+
+/*
+** Interned desk / book / currency names. Ids are assigned on first sight as rows are
+** added and never change, so a filter can resolve a name to an id set once
+** and then test the uint8 column. At most one new name per row, so the
+** table can never overflow.
+*/
+typedef struct {
+  const char *names[MAX_POSITIONS];
+  int         count;
+} NameDict;
+
+/*
+** Precomputed row sets per category value (sel.h bitmaps), kept up to date
+** as rows are added. Category filters (asset-class toggles, desk:/book:
+** terms) are ORs of these instead of scans over the book.
+*/
+typedef struct {
+  uint64_t asset[ASSET_CLASS_COUNT][SEL_WORDS(MAX_POSITIONS)];
+  uint64_t desk[MAX_POSITIONS][SEL_WORDS(MAX_POSITIONS)];
+  uint64_t book[MAX_POSITIONS][SEL_WORDS(MAX_POSITIONS)];
+} BookBitmaps;
+
+/* ---- Book-wide aggregates, maintained incrementally on every mutation ---- */
+typedef struct {
+  FxNotional notional;
+  FxPnl      pnl_total;
+  FxPnl      pnl_day;
+  FxPnl      pnl_realized;
+  FxPnl      pnl_unrealized;
+  FxPnl      pnl_carry;        /* non-price accruals (data_accrue_pnl) */
+  int        n_open;           /* positions with non-zero notional */
+} BookTotals;
+
+/*
+** Bucketed DV01 (key-rate ladder), one float per bucket per row: 64 bytes,
+** one cache line, a row. The feed publishes a single DV01 per position, so
+** the book buckets it at the row's maturity (a swaption's expiry + tenor,
+** else parsed from the instrument once, when the row is added): split
+** linearly between the two ladder
+** tenors around it, all of it in the end bucket outside 3M..50Y — the
+** par-point profile of a single-maturity instrument. Refreshed with the
+** other columns on every row edit.
+*/
+#define LADDER_BUCKETS 16
+
+static const float LADDER_YEARS[LADDER_BUCKETS] __attribute__((unused)) = {
+  0.25f, 0.5f, 1, 2, 3, 4, 5, 7, 10, 12, 15, 20, 25, 30, 40, 50
+};
+
+static const char *const LADDER_LABELS[LADDER_BUCKETS] __attribute__((unused)) = {
+  "3M", "6M", "1Y", "2Y", "3Y", "4Y", "5Y", "7Y",
+  "10Y", "12Y", "15Y", "20Y", "25Y", "30Y", "40Y", "50Y"
+};
+
+typedef struct {
+  _Alignas(64) float dv01[MAX_POSITIONS][LADDER_BUCKETS];
+  float years[MAX_POSITIONS];                     /* maturity bucketed at */
+} BookLadder;
+
+/*
+** Journal of edited rows, one entry per value_epoch: the row edit that
+** moved value_epoch from e to e + 1 is rows[e % BOOK_LOG_LEN]. Consumers
+** keeping per-row derived state (movers.h) replay it from their own
+** epoch instead of rescanning the book; one more than BOOK_LOG_LEN edits
+** behind has lost entries and rebuilds.
+*/
+#define BOOK_LOG_LEN 4096
+
+/*
+** Sums kept by delta from the journal (pivot.h, ladder.h, vega.h) pick
+** up a rounding error per replayed edit; each re-bases from a full pass
+** over the book once this many epochs have gone by since its last one.
+*/
+#define BOOK_REBASE_EPOCHS (4 * BOOK_LOG_LEN)
+
+typedef struct {
+  uint16_t rows[BOOK_LOG_LEN];
+} BookLog;
+
 /* ---- Global Position Book ---- */
 typedef struct {
-  Position items[MAX_POSITIONS];
-  int      count;
+  Position   items[MAX_POSITIONS];
+  int        count;
+  BookTotals totals;
+  BookColumns cols;
+  BookLadder ladder;
+  NameDict   desks;
+  NameDict   books;
+  NameDict   ccys;
+  BookBitmaps sets;
+  unsigned   struct_epoch;     /* bumped when rows are added */
+  unsigned   value_epoch;      /* bumped on every row edit */
+  BookLog    log;              /* row behind each value_epoch bump */
 } PositionBook;
 
 /* ---- Initialize with realistic rates desk data ---- */
 void data_init(PositionBook *book);
 
-/* ---- Simulate market data tick (random walk + theta bleed) ---- */
-void data_simulate_tick(PositionBook *book, int tick);
+/*
+** Book mutation. The book has a single writer (the UI thread, which also
+** drains the ingest rings); every feed update funnels through these.
+*/
+
+/* ---- Re-mark a position, carrying the move into P&L ---- */
+void data_mark_price(PositionBook *book, int idx, double px);
+
+/* ---- Accrue P&L that isn't price driven (theta bleed, carry) ---- */
+void data_accrue_pnl(PositionBook *book, int idx, double pnl);
+
+/* ---- Replace a position's sensitivities ---- */
+void data_set_risk(PositionBook *book, int idx, const PositionRisk *risk);
+
+/*
+** Apply a trade fill (qty in millions, signed: + buy / - sell).
+** Adds extend the position at a size-weighted average price; reductions
+** realize (px - avg) on the closed size; crossing zero flips the position
+** and opens the remainder at px. O(1): book totals move by delta.
+** Fills at px <= 0 are rejected.
+*/
+void data_apply_fill(PositionBook *book, int idx, double qty, double px);
+
+/* ---- Append a new (flat) position line. Returns its index or -1. ---- */
+int  data_open_position(PositionBook *book, const Position *tmpl);
+
+/* ---- Read any numeric field as double ---- */
+double data_field(const Position *p, NumField f);
+
+/* ---- Unrealized P&L (K) of the open size against the current mark ---- */
+FxPnl data_pnl_unrealized(const Position *p);
+
+/*
+** ---- Maturity in years from an instrument name ----
+** The first tenor token ("10Y", "3M"); an expiry x tenor pair ("1Yx5Y")
+** adds up to the underlying's end. 10 when there is none.
+*/
+float data_maturity_years(const char *instrument);
+
+/* ---- Short display codes for book / desk names ("US Rates" → "USR") ---- */
+const char *data_book_short(const char *book);
+const char *data_desk_short(const char *desk);
 
 #endif
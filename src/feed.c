@@ -0,0 +1,156 @@
+/*
+** feed.c — Simulated feed threads
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include "feed.h"
+
+#define PRICE_PERIOD_MS  250
+#define TRADE_PERIOD_MS  100
+#define RISK_PERIOD_MS   1000
+
+/* ---- Per-thread PRNG (rand() is not thread-safe) ---- */
+static uint32_t xorshift32(uint32_t *s) {
+  uint32_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *s = x;
+  return x;
+}
+
+/* uniform in [-1, 1] */
+static double noise(uint32_t *s) {
+  return (double)(xorshift32(s) % 2001u) / 1000.0 - 1.0;
+}
+
+static void sleep_ms(long ms) {
+  struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+  nanosleep(&ts, NULL);
+}
+
+/* Publish, backing off while the consumer catches up. Gives up if the sim is
+   being stopped so feed_stop() never waits on a full ring. */
+static void publish(FeedSim *fs, FeedKind kind, const IngestEvent *ev) {
+  while (!ingest_push(fs->hub, fs->producer[kind], ev)) {
+    if (!atomic_load_explicit(&fs->running, memory_order_relaxed)) return;
+    sched_yield();
+  }
+}
+
+
+/* ============================================================================
+**  Feed Threads
+** ============================================================================*/
+
+static void *price_thread(void *arg) {
+  FeedSim *fs = arg;
+  uint32_t seed = 0x9e3779b9u;
+
+  while (atomic_load_explicit(&fs->running, memory_order_relaxed)) {
+    for (int i = 0; i < fs->n_pos; i++) {
+      IngestEvent ev = { .kind = INGEST_PRICE, .pos = i };
+      if (fs->px[i] > 0.01) fs->px[i] += noise(&seed) / 100.0;
+      ev.price.px    = fs->px[i];
+      ev.price.carry = fs->carry[i];
+      publish(fs, FEED_PRICES, &ev);
+    }
+    sleep_ms(PRICE_PERIOD_MS);
+  }
+  return NULL;
+}
+
+
+static void *trade_thread(void *arg) {
+  FeedSim *fs = arg;
+  uint32_t seed = 0x85ebca6bu;
+
+  while (atomic_load_explicit(&fs->running, memory_order_relaxed)) {
+    if (fs->n_pos > 0 && xorshift32(&seed) % 4u == 0) {
+      int i = (int)(xorshift32(&seed) % (uint32_t)fs->n_pos);
+      IngestEvent ev = { .kind = INGEST_TRADE, .pos = i };
+      ev.trade.qty = (double)((int)(xorshift32(&seed) % 21u) - 10);  /* ±10MM */
+      ev.trade.px  = fs->ref_px[i] + noise(&seed) / 50.0;
+      /* rows with no reference price (unpriced swaptions) don't trade */
+      if (ev.trade.qty != 0.0 && fs->ref_px[i] > 0.01) publish(fs, FEED_TRADES, &ev);
+    }
+    sleep_ms(TRADE_PERIOD_MS);
+  }
+  return NULL;
+}
+
+
+static void *risk_thread(void *arg) {
+  FeedSim *fs = arg;
+  uint32_t seed = 0xc2b2ae35u;
+
+  while (atomic_load_explicit(&fs->running, memory_order_relaxed)) {
+    for (int i = 0; i < fs->n_pos; i++) {
+      const PositionRisk *b = &fs->risk[i];
+      double k = 1.0 + noise(&seed) * 0.02;   /* ±2% re-calibration noise */
+      IngestEvent ev = { .kind = INGEST_RISK, .pos = i };
+      ev.risk = (PositionRisk){
+        .dv01 = b->dv01 * k, .cs01  = b->cs01  * k, .delta = b->delta,
+        .gamma = b->gamma,   .vega  = b->vega  * k, .theta = b->theta,
+      };
+      publish(fs, FEED_RISK, &ev);
+    }
+    sleep_ms(RISK_PERIOD_MS);
+  }
+  return NULL;
+}
+
+
+/* ============================================================================
+**  Lifecycle
+** ============================================================================*/
+
+int feed_start(FeedSim *fs, IngestHub *hub, const PositionBook *book) {
+  memset(fs, 0, sizeof(*fs));
+  fs->hub   = hub;
+  fs->n_pos = book->count;
+
+  for (int i = 0; i < book->count; i++) {
+    const Position *p = &book->items[i];
+    double mkt = FX_PRICE_D(p->mkt_price);
+    fs->px[i]     = mkt;
+    fs->carry[i]  = p->theta * 0.001;
+    fs->ref_px[i] = mkt > 0.01 ? mkt : FX_PRICE_D(p->avg_price);
+    fs->risk[i]   = (PositionRisk){
+      p->dv01, p->cs01, p->delta, p->gamma, p->vega, p->theta
+    };
+  }
+
+  static const char *const names[FEED_COUNT] = { "prices", "trades", "risk" };
+  for (int k = 0; k < FEED_COUNT; k++) {
+    fs->producer[k] = ingest_register(hub, names[k]);
+    if (fs->producer[k] < 0) return -1;
+  }
+
+  atomic_store(&fs->running, 1);
+
+  void *(*const entry[FEED_COUNT])(void *) = {
+    price_thread, trade_thread, risk_thread
+  };
+  for (int k = 0; k < FEED_COUNT; k++) {
+    if (pthread_create(&fs->threads[k], NULL, entry[k], fs) != 0) {
+      feed_stop(fs);
+      return -1;
+    }
+    fs->started[k] = 1;
+  }
+  return 0;
+}
+
+
+void feed_stop(FeedSim *fs) {
+  atomic_store(&fs->running, 0);
+  for (int k = 0; k < FEED_COUNT; k++) {
+    if (fs->started[k]) pthread_join(fs->threads[k], NULL);
+    fs->started[k] = 0;
+  }
+}
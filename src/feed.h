@@ -0,0 +1,49 @@
+/*
+** feed.h — Simulated Market / Trade / Risk Feeds
+**
+** Stand-ins for the production sources, one thread each:
+**   prices  — random-walk marks every 250ms + theta bleed
+**   trades  — sporadic small drop-copy fills near the mark
+**   risk    — sensitivity refresh every second (noise around base)
+**
+** Each thread owns its model state (seeded from the book before the threads
+** start) and only talks to the book through its IngestHub ring.
+*/
+
+#ifndef FEED_H
+#define FEED_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "data.h"
+#include "ingest.h"
+
+typedef enum {
+  FEED_PRICES,
+  FEED_TRADES,
+  FEED_RISK,
+  FEED_COUNT
+} FeedKind;
+
+typedef struct {
+  IngestHub    *hub;
+  int           n_pos;
+  int           producer[FEED_COUNT];   /* ring id per feed */
+  pthread_t     threads[FEED_COUNT];
+  int           started[FEED_COUNT];
+  _Atomic int   running;
+
+  /* Per-feed model state — each array is touched by exactly one thread */
+  double        px[MAX_POSITIONS];       /* prices: current mark          */
+  double        carry[MAX_POSITIONS];    /* prices: theta bleed per cycle */
+  double        ref_px[MAX_POSITIONS];   /* trades: fill price ref, 0 = none */
+  PositionRisk  risk[MAX_POSITIONS];     /* risk:   base sensitivities    */
+} FeedSim;
+
+/* ---- Register rings and start one thread per feed. Returns 0 on success. ---- */
+int  feed_start(FeedSim *fs, IngestHub *hub, const PositionBook *book);
+
+/* ---- Signal threads to stop and join them ---- */
+void feed_stop(FeedSim *fs);
+
+#endif
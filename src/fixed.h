@@ -0,0 +1,60 @@
+/*
+** fixed.h — Storage Types for Money Columns
+**
+** Default build: prices, notionals and P&L are doubles.
+** BBG_FIXED build (make BBG_FIXED=1): they are scaled int64, so summation
+** is exact integer addition and formatting is pure integer → decimal.
+**
+**   FxPrice     price / rate       1e-6       (0.000001)
+**   FxNotional  notional, MM       1e-6 MM    ($1)
+**   FxPnl       P&L, thousands     1e-5 K     (1 cent)
+**
+** Code touching these fields converts at the edges with the FX_* macros:
+**   FX_PRICE(d)    double → storage (rounds half away from zero)
+**   FX_PRICE_D(x)  storage → double
+** In the default build both are identity, so there is one code path.
+** Products (price × notional) are formed in double and rounded once.
+*/
+
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+
+#define FX_PRICE_DIGITS    6
+#define FX_NOTIONAL_DIGITS 6
+#define FX_PNL_DIGITS      5
+
+#ifdef BBG_FIXED
+
+typedef int64_t FxPrice;
+typedef int64_t FxNotional;
+typedef int64_t FxPnl;
+
+static inline int64_t fx_round(double d) {
+  return (int64_t)(d < 0 ? d - 0.5 : d + 0.5);
+}
+
+#define FX_PRICE(d)       fx_round((d) * 1e6)
+#define FX_NOTIONAL(d)    fx_round((d) * 1e6)
+#define FX_PNL(d)         fx_round((d) * 1e5)
+#define FX_PRICE_D(x)     ((double)(x) * 1e-6)
+#define FX_NOTIONAL_D(x)  ((double)(x) * 1e-6)
+#define FX_PNL_D(x)       ((double)(x) * 1e-5)
+
+#else
+
+typedef double FxPrice;
+typedef double FxNotional;
+typedef double FxPnl;
+
+#define FX_PRICE(d)       (d)
+#define FX_NOTIONAL(d)    (d)
+#define FX_PNL(d)         (d)
+#define FX_PRICE_D(x)     (x)
+#define FX_NOTIONAL_D(x)  (x)
+#define FX_PNL_D(x)       (x)
+
+#endif
+
+#endif
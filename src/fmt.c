@@ -0,0 +1,245 @@
+/*
+** fmt.c — Numeric cell formatters
+*/
+
+#include <math.h>
+#include <string.h>
+#include "fmt.h"
+
+__extension__ typedef unsigned __int128 u128;
+
+static const uint64_t POW10[19] = {
+  1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+  10000000ull, 100000000ull, 1000000000ull, 10000000000ull,
+  100000000000ull, 1000000000000ull, 10000000000000ull,
+  100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+  100000000000000000ull, 1000000000000000000ull
+};
+
+static const uint64_t POW5[FMT_MAX_DECIMALS + 1] = {
+  1ull, 5ull, 25ull, 125ull, 625ull, 3125ull, 15625ull, 78125ull,
+  390625ull, 1953125ull, 9765625ull, 48828125ull, 244140625ull,
+  1220703125ull, 6103515625ull, 30517578125ull, 152587890625ull,
+  762939453125ull, 3814697265625ull
+};
+
+/* ============================================================================
+**  Right-to-Left Emission
+** ============================================================================
+**
+** Both formatters build the string backwards in a scratch buffer: suffix,
+** fraction digits, point, integer digits (with separators), sign. A
+** double's integer part can run to 309 digits; 448 bytes covers that with
+** separators, fraction and suffix.
+*/
+
+#define FMT_TMP 448
+
+typedef struct {
+  char tmp[FMT_TMP];
+  int  n;
+  int  ndigits;                 /* integer digits so far, for separators */
+  int  comma;
+} Emit;
+
+static void emit_suffix(Emit *e, int flags) {
+  if (flags & FMT_MM)     { e->tmp[e->n++] = 'M'; e->tmp[e->n++] = 'M'; }
+  else if (flags & FMT_K) { e->tmp[e->n++] = 'K'; }
+}
+
+/* `zeros` trailing zeros, `count` fraction digits of q (< 10^count), point */
+static void emit_fraction(Emit *e, uint64_t q, int count, int zeros) {
+  for (int d = 0; d < zeros; d++) e->tmp[e->n++] = '0';
+  for (int d = 0; d < count; d++) {
+    e->tmp[e->n++] = (char)('0' + (int)(q % 10));
+    q /= 10;
+  }
+  if (count + zeros > 0) e->tmp[e->n++] = '.';
+}
+
+static void emit_digit(Emit *e, int digit) {
+  if (e->comma && e->ndigits && e->ndigits % 3 == 0) e->tmp[e->n++] = ',';
+  e->tmp[e->n++] = (char)('0' + digit);
+  e->ndigits++;
+}
+
+static void emit_u64(Emit *e, uint64_t u) {
+  do {
+    emit_digit(e, (int)(u % 10));
+    u /= 10;
+  } while (u);
+}
+
+static int emit_finish(Emit *e, char *buf, int cap, int neg, int flags) {
+  if (neg)                   e->tmp[e->n++] = '-';
+  else if (flags & FMT_PLUS) e->tmp[e->n++] = '+';
+
+  int len = (e->n < cap - 1) ? e->n : cap - 1;
+  for (int i = 0; i < len; i++) buf[i] = e->tmp[e->n - 1 - i];
+  buf[len] = '\0';
+  return len;
+}
+
+
+int fmt_scaled(char *buf, int cap, int64_t v, int scale, int decimals, int flags) {
+  if (cap <= 0) return 0;
+  if (flags & FMT_MM)     scale += 6;       /* exact: just a wider scale */
+  else if (flags & FMT_K) scale += 3;
+  if (scale < 0)     scale = 0;
+  if (scale > 18)    scale = 18;
+  if (decimals < 0)  decimals = 0;
+  if (decimals > 18) decimals = 18;
+
+  int      neg = v < 0;
+  uint64_t u   = neg ? 0ull - (uint64_t)v : (uint64_t)v;
+
+  /* Rescale so u == |value| * 10^digits; decimals past the scale are
+     zeros, emitted rather than multiplied into u (which could overflow) */
+  int digits = decimals < scale ? decimals : scale;
+  if (decimals < scale) {
+    uint64_t div = POW10[scale - decimals];
+    uint64_t r   = u % div;
+    u /= div;
+    if (r >= div - r) u++;          /* half away from zero */
+  }
+
+  Emit e;
+  e.n = 0; e.ndigits = 0; e.comma = flags & FMT_COMMA;
+  emit_suffix(&e, flags);
+  emit_fraction(&e, u % POW10[digits], digits, decimals - digits);
+  emit_u64(&e, u / POW10[digits]);
+  return emit_finish(&e, buf, cap, neg, flags);
+}
+
+
+/* ============================================================================
+**  Doubles
+** ============================================================================
+**
+** v = m * 2^x with m < 2^53. For x < 0 the integer part is m >> -x and
+** the fraction f / 2^-x; its `decimals` digits are f * 10^d / 2^-x, i.e.
+** (f * 5^d) >> (-x - d), which fits 128 bits for d <= 18, and the bits
+** shifted out decide the rounding exactly — no double arithmetic on the
+** value, so ties and near-ties land as glibc's printf lands them. For
+** x >= 0 the value is an integer: up to 2^64 directly, beyond that by
+** doubling a base-1e9 bignum (only absurd magnitudes get there).
+*/
+
+/* Integer m * 2^x (x > 11) as decimal digits, most significant limb last */
+static void emit_big(Emit *e, uint64_t m, int x) {
+  uint32_t limb[40];                        /* 2^1024 < 10^309 < 1e9^35 */
+  int      n = 0;
+  while (m) { limb[n++] = (uint32_t)(m % 1000000000u); m /= 1000000000u; }
+  while (x > 0) {
+    int      k     = x < 29 ? x : 29;       /* limb * 2^29 fits 64 bits */
+    uint64_t carry = 0;
+    for (int i = 0; i < n; i++) {
+      uint64_t t = ((uint64_t)limb[i] << k) + carry;
+      limb[i] = (uint32_t)(t % 1000000000u);
+      carry   = t / 1000000000u;
+    }
+    while (carry) { limb[n++] = (uint32_t)(carry % 1000000000u); carry /= 1000000000u; }
+    x -= k;
+  }
+  for (int i = 0; i < n - 1; i++) {
+    uint32_t l = limb[i];
+    for (int d = 0; d < 9; d++) { emit_digit(e, (int)(l % 10)); l /= 10; }
+  }
+  emit_u64(e, limb[n - 1]);
+}
+
+static int fmt_special(char *buf, int cap, double v, int neg, int flags) {
+  Emit e;
+  const char *s = isnan(v) ? "nan" : "inf";
+  e.n = 0; e.ndigits = 0; e.comma = 0;
+  emit_suffix(&e, flags);
+  for (int i = 2; i >= 0; i--) e.tmp[e.n++] = s[i];
+  return emit_finish(&e, buf, cap, neg, flags);
+}
+
+int fmt_f64(char *buf, int cap, double v, int decimals, int flags) {
+  if (cap <= 0) return 0;
+  if (decimals < 0)                decimals = 0;
+  if (decimals > FMT_MAX_DECIMALS) decimals = FMT_MAX_DECIMALS;
+
+  int neg = signbit(v) != 0;
+  if (!isfinite(v)) return fmt_special(buf, cap, v, neg, flags);
+  if (flags & FMT_MM)     v /= 1e6;
+  else if (flags & FMT_K) v /= 1e3;
+
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  int      bexp = (int)((bits >> 52) & 0x7FF);
+  uint64_t m    = bits & ((1ull << 52) - 1);
+  int      x    = bexp ? bexp - 1075 : -1074;
+  if (bexp) m |= 1ull << 52;
+
+  Emit e;
+  e.n = 0; e.ndigits = 0; e.comma = flags & FMT_COMMA;
+  emit_suffix(&e, flags);
+
+  if (x >= 0) {
+    emit_fraction(&e, 0, 0, decimals);
+    if (x <= 11) emit_u64(&e, m << x);
+    else         emit_big(&e, m, x);
+    return emit_finish(&e, buf, cap, neg, flags);
+  }
+
+  int      s    = -x;
+  uint64_t ip   = s < 64 ? m >> s : 0;
+  uint64_t f    = s < 64 ? m & ((1ull << s) - 1) : m;
+  u128     p    = (u128)f * POW5[decimals];
+  int      t    = s - decimals;             /* bits below the last digit */
+  uint64_t q;
+  if (t <= 0) {
+    q = (uint64_t)(p << -t);                /* exact, nothing to round */
+  } else if (t >= 128) {
+    q = 0;                                  /* p < 2^95: under half */
+  } else {
+    q = (uint64_t)(p >> t);
+    u128 r    = p & (((u128)1 << t) - 1);
+    u128 half = (u128)1 << (t - 1);
+    int  odd  = (int)((decimals ? q : ip) & 1);
+    if (r > half || (r == half && odd)) q++;  /* half to even */
+  }
+  if (q == POW10[decimals]) { q = 0; ip++; }
+
+  emit_fraction(&e, q, decimals, 0);
+  emit_u64(&e, ip);
+  return emit_finish(&e, buf, cap, neg, flags);
+}
+
+
+/* ============================================================================
+**  Book Storage Types
+** ============================================================================*/
+
+#ifdef BBG_FIXED
+
+int fmt_price(char *buf, int cap, FxPrice v, int decimals, int flags) {
+  return fmt_scaled(buf, cap, v, FX_PRICE_DIGITS, decimals, flags);
+}
+
+int fmt_notional(char *buf, int cap, FxNotional v, int decimals, int flags) {
+  return fmt_scaled(buf, cap, v, FX_NOTIONAL_DIGITS, decimals, flags);
+}
+
+int fmt_pnl(char *buf, int cap, FxPnl v, int decimals, int flags) {
+  return fmt_scaled(buf, cap, v, FX_PNL_DIGITS, decimals, flags);
+}
+
+#else
+
+int fmt_price(char *buf, int cap, FxPrice v, int decimals, int flags) {
+  return fmt_f64(buf, cap, v, decimals, flags);
+}
+
+int fmt_notional(char *buf, int cap, FxNotional v, int decimals, int flags) {
+  return fmt_f64(buf, cap, v, decimals, flags);
+}
+
+int fmt_pnl(char *buf, int cap, FxPnl v, int decimals, int flags) {
+  return fmt_f64(buf, cap, v, decimals, flags);
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+** fmt.h — Numeric Cell Formatting
+**
+** printf-free formatters for grid cells. All return the string length and
+** always NUL-terminate (truncating if cap is too small).
+*/
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+#include "fixed.h"
+
+/* ---- Flags ---- */
+#define FMT_PLUS   (1 << 0)     /* force '+' on non-negative values */
+#define FMT_COMMA  (1 << 1)     /* thousands separators: 1,234,567.8 */
+#define FMT_K      (1 << 2)     /* value / 1e3, suffixed "K" */
+#define FMT_MM     (1 << 3)     /* value / 1e6, suffixed "MM" (wins over K) */
+
+#define FMT_MAX_DECIMALS 18
+
+/*
+** Format a scaled integer v * 10^-scale with `decimals` fraction digits.
+** Extra digits are rounded half away from zero; missing ones zero-filled.
+** Negative values that round to zero keep their '-' (matches printf).
+*/
+int fmt_scaled(char *buf, int cap, int64_t v, int scale, int decimals, int flags);
+
+/*
+** Format a double with `decimals` fraction digits, byte-for-byte what
+** snprintf("%.*f") / ("%+.*f") prints in the C locale: the exact binary
+** value is rounded half to even, -0 and negatives that round to zero
+** keep their '-', and inf / nan print as such. Digits come from integer
+** arithmetic on the mantissa, never from printf. With FMT_K / FMT_MM the
+** value is divided first (same result as printf of v / 1e3, v / 1e6).
+*/
+int fmt_f64(char *buf, int cap, double v, int decimals, int flags);
+
+/* ---- Book storage types (exact integer path in BBG_FIXED builds) ---- */
+int fmt_price(char *buf, int cap, FxPrice v, int decimals, int flags);
+int fmt_notional(char *buf, int cap, FxNotional v, int decimals, int flags);
+int fmt_pnl(char *buf, int cap, FxPnl v, int decimals, int flags);
+
+#endif
@@ -0,0 +1,192 @@
+/*
+** group.c — Group-By (hash grouping on categorical columns)
+*/
+
+#include <string.h>
+#include "group.h"
+
+static const char *const DIM_NAME[GROUP_DIM_COUNT] = { "Book", "Desk", "Asset", "Ccy" };
+
+const char *group_dim_name(GroupDim d) {
+  return DIM_NAME[d];
+}
+
+
+int group_spec_eq(const GroupSpec *a, const GroupSpec *b) {
+  if (a->n != b->n) return 0;
+  for (int i = 0; i < a->n; i++) {
+    if (a->dims[i] != b->dims[i]) return 0;
+  }
+  return 1;
+}
+
+
+static uint8_t dim_id(const PositionBook *book, int dim, int row) {
+  switch (dim) {
+    case GROUP_BOOK:  return book->cols.book[row];
+    case GROUP_DESK:  return book->cols.desk[row];
+    case GROUP_ASSET: return book->cols.asset[row];
+    default:          return book->cols.ccy[row];
+  }
+}
+
+uint32_t group_row_key(const GroupSpec *spec, const PositionBook *book, int row) {
+  uint32_t key = 0;
+  for (int i = 0; i < spec->n; i++) key |= (uint32_t)dim_id(book, spec->dims[i], row) << (8 * i);
+  return key;
+}
+
+static inline uint32_t key_hash(uint32_t key) {
+  return (key * 2654435761u) >> (32 - GROUP_HASH_BITS);
+}
+
+/* Group index for key, appending a new group on first sight */
+static int find_or_add(GroupSet *g, uint32_t key) {
+  uint32_t h = key_hash(key);
+  for (;;) {
+    int s = g->slot[h];
+    if (!s) break;
+    if (g->groups[s - 1].key == key) return s - 1;
+    h = (h + 1) & (GROUP_HASH_SIZE - 1);
+  }
+  int gi = g->ngroups++;
+  Group *grp = &g->groups[gi];
+  grp->key   = key;
+  grp->count = 0;
+  memset(grp->sel, 0, sizeof(grp->sel));
+  g->slot[h] = (uint16_t)(gi + 1);
+  return gi;
+}
+
+
+void group_build(GroupSet *g, const GroupSpec *spec, const PositionBook *book,
+                 const int *rows, int n)
+{
+  g->ngroups = 0;
+  g->count   = n;
+  memset(g->slot, 0, sizeof(g->slot));
+
+  /* Pass 1: hash each row to its group, counting */
+  uint8_t gid[MAX_POSITIONS];
+  for (int i = 0; i < n; i++) {
+    int gi = find_or_add(g, group_row_key(spec, book, rows[i]));
+    gid[i] = (uint8_t)gi;
+    g->groups[gi].count++;
+    sel_set(g->groups[gi].sel, rows[i]);
+  }
+
+  /* Pass 2: stable scatter into each group's span */
+  int at[GROUP_MAX];
+  for (int gi = 0, off = 0; gi < g->ngroups; gi++) {
+    g->groups[gi].first = off;
+    at[gi] = off;
+    off += g->groups[gi].count;
+  }
+  for (int i = 0; i < n; i++) g->rows[at[gid[i]]++] = rows[i];
+}
+
+
+static const char *dim_text(const PositionBook *book, int dim, uint8_t id) {
+  switch (dim) {
+    case GROUP_BOOK:  return book->books.names[id];
+    case GROUP_DESK:  return book->desks.names[id];
+    case GROUP_ASSET: return ASSET_CLASS_NAMES[id];
+    default:          return book->ccys.names[id];
+  }
+}
+
+static int append(char *buf, int len, int cap, const char *s) {
+  while (*s && len < cap - 1) buf[len++] = *s++;
+  buf[len] = '\0';
+  return len;
+}
+
+int group_label(const GroupSpec *spec, const PositionBook *book, uint32_t key,
+                char *buf, int cap)
+{
+  int len = 0;
+  buf[0] = '\0';
+  for (int i = 0; i < spec->n; i++) {
+    if (i) len = append(buf, len, cap, " / ");
+    len = append(buf, len, cap, dim_text(book, spec->dims[i], (uint8_t)(key >> (8 * i))));
+  }
+  return len;
+}
+
+
+/* ============================================================================
+**  Collapsed Groups
+** ============================================================================*/
+
+#define FOLD_DELETED UINT32_MAX
+
+/* Spec in the top byte (n >= 1, so never 0), group key below; ids are
+   < MAX_POSITIONS, so never FOLD_DELETED either */
+static uint32_t fold_id(const GroupSpec *spec, uint32_t key) {
+  uint32_t sig = (uint32_t)spec->n << 6;
+  for (int i = 0; i < spec->n; i++) sig |= (uint32_t)spec->dims[i] << (2 * i);
+  return sig << 24 | key;
+}
+
+static inline uint32_t fold_hash(uint32_t id) {
+  return (id * 2654435761u) >> (32 - GROUP_FOLD_BITS);
+}
+
+/* Slot holding id, or -1 */
+static int fold_find(const GroupFolds *f, uint32_t id) {
+  for (uint32_t h = fold_hash(id); ; h = (h + 1) & (GROUP_FOLD_SIZE - 1)) {
+    if (f->ids[h] == id) return (int)h;
+    if (f->ids[h] == 0)  return -1;
+  }
+}
+
+
+int group_folded(const GroupFolds *f, const GroupSpec *spec, uint32_t key) {
+  return spec->n > 0 && f->count > 0 && fold_find(f, fold_id(spec, key)) >= 0;
+}
+
+
+int group_fold_set(GroupFolds *f, const GroupSpec *spec, uint32_t key, int folded) {
+  if (spec->n == 0) return -1;
+  uint32_t id = fold_id(spec, key);
+  int at = fold_find(f, id);
+
+  if (!folded) {
+    if (at >= 0) {
+      f->ids[at] = FOLD_DELETED;
+      f->count--;
+    }
+    return 0;
+  }
+  if (at >= 0) return 0;
+
+  /* Too many tombstones: rehash the live entries in place of a full table */
+  if (f->used >= GROUP_FOLD_MAX) {
+    if (f->count >= GROUP_FOLD_MAX) return -1;
+    static uint32_t live[GROUP_FOLD_SIZE];
+    int n = 0;
+    for (int i = 0; i < GROUP_FOLD_SIZE; i++) {
+      if (f->ids[i] && f->ids[i] != FOLD_DELETED) live[n++] = f->ids[i];
+    }
+    memset(f->ids, 0, sizeof(f->ids));
+    f->count = f->used = 0;
+    for (int i = 0; i < n; i++) {
+      uint32_t h = fold_hash(live[i]);
+      while (f->ids[h]) h = (h + 1) & (GROUP_FOLD_SIZE - 1);
+      f->ids[h] = live[i];
+    }
+    f->count = f->used = n;
+  }
+
+  uint32_t h = fold_hash(id);
+  while (f->ids[h] && f->ids[h] != FOLD_DELETED) h = (h + 1) & (GROUP_FOLD_SIZE - 1);
+  if (f->ids[h] == 0) f->used++;
+  f->ids[h] = id;
+  f->count++;
+  return 0;
+}
+
+
+void group_fold_clear(GroupFolds *f) {
+  memset(f, 0, sizeof(*f));
+}
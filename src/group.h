@@ -0,0 +1,97 @@
+/*
+** group.h — Group-By (hash grouping on categorical columns)
+**
+** Buckets a list of rows by up to GROUP_MAX_DIMS categorical columns
+** (book, desk, asset class, currency — the interned uint8 columns of
+** BookColumns). The dims' ids pack into one uint32 key; an open-addressed
+** hash table maps keys to groups, so grouping is one O(n) pass whatever
+** order the rows come in — no reliance on the book being seeded or sorted
+** by group, and rows appended later simply join (or start) their group.
+**
+** Groups come out in order of first appearance in the input, and each
+** group's rows keep their input order: feed it the screen's sorted rows
+** and groups order by their best row, rows within a group by the sort.
+** Each group also carries a selection bitmap for agg_* subtotals.
+**
+** GroupFolds is a set of collapsed groups, keyed by spec and group key so
+** it outlives regrouping and switching specs back and forth. It is an
+** open-addressed table of its own (not microui's treenode pool, which is
+** per context and fixed at MU_TREENODEPOOL_SIZE), so it holds thousands.
+*/
+
+#ifndef GROUP_H
+#define GROUP_H
+
+#include <stdint.h>
+#include "data.h"
+
+#define GROUP_MAX_DIMS  3
+#define GROUP_MAX       MAX_POSITIONS       /* at most one group per row */
+#define GROUP_HASH_BITS 8                   /* 2x GROUP_MAX slots */
+#define GROUP_HASH_SIZE (1 << GROUP_HASH_BITS)
+
+typedef enum {
+  GROUP_BOOK,
+  GROUP_DESK,
+  GROUP_ASSET,
+  GROUP_CCY,
+  GROUP_DIM_COUNT
+} GroupDim;
+
+typedef struct {
+  uint8_t  dims[GROUP_MAX_DIMS];            /* GroupDim, outermost first */
+  int      n;                               /* 0 = no grouping */
+} GroupSpec;
+
+typedef struct {
+  uint32_t  key;                            /* dim ids, 8 bits each */
+  int       first;                          /* into GroupSet.rows */
+  int       count;
+  uint64_t  sel[SEL_WORDS(MAX_POSITIONS)];
+} Group;
+
+typedef struct {
+  Group     groups[GROUP_MAX];              /* first-appearance order */
+  int       ngroups;
+  int       rows[MAX_POSITIONS];            /* input rows, bucketed by group */
+  int       count;
+  uint16_t  slot[GROUP_HASH_SIZE];          /* group index + 1, 0 = empty */
+} GroupSet;
+
+#define GROUP_FOLD_BITS 12
+#define GROUP_FOLD_SIZE (1 << GROUP_FOLD_BITS)
+#define GROUP_FOLD_MAX  (GROUP_FOLD_SIZE * 3 / 4)
+
+typedef struct {
+  uint32_t  ids[GROUP_FOLD_SIZE];           /* 0 = empty, UINT32_MAX = deleted */
+  int       count;                          /* live entries */
+  int       used;                           /* live + deleted */
+} GroupFolds;
+
+/* ---- 1 if the specs are the same ---- */
+int  group_spec_eq(const GroupSpec *a, const GroupSpec *b);
+
+/* ---- Short dim name ("Book", "Ccy", ...) ---- */
+const char *group_dim_name(GroupDim d);
+
+/* ---- Packed key of row under spec (0 when spec->n is 0) ---- */
+uint32_t group_row_key(const GroupSpec *spec, const PositionBook *book, int row);
+
+/* ---- Bucket rows[0, n) by spec ---- */
+void group_build(GroupSet *g, const GroupSpec *spec, const PositionBook *book,
+                 const int *rows, int n);
+
+/* ---- "Rates Flow / US Rates" for a group's key. Returns the length. ---- */
+int  group_label(const GroupSpec *spec, const PositionBook *book, uint32_t key,
+                 char *buf, int cap);
+
+/* ---- 1 if the group with key (under spec) is collapsed ---- */
+int  group_folded(const GroupFolds *f, const GroupSpec *spec, uint32_t key);
+
+/* ---- Collapse / expand a group. Returns 0, or -1 if the set is full. ---- */
+int  group_fold_set(GroupFolds *f, const GroupSpec *spec, uint32_t key, int folded);
+
+/* ---- Expand every group ---- */
+void group_fold_clear(GroupFolds *f);
+
+#endif
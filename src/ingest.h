@@ -0,0 +1,92 @@
+/*
+** ingest.h — Multi-Producer Feed Ingestion
+**
+** Each feed (prices, trade drop copies, risk sensitivities) runs on its own
+** thread and owns one single-producer/single-consumer ring. The UI thread
+** is the only consumer: once per frame it drains all rings round-robin and
+** applies events to the PositionBook through the data_* mutation API.
+**
+** Ordering: a ring is FIFO, so every event a feed publishes for a given
+** position is applied in publication order. Feeds are independent sources,
+** so there is no ordering between two feeds (nor should there be).
+**
+** Lock-free: head/tail are C11 atomics on separate cache lines, each side
+** caches the other's index and only re-reads it when the ring looks
+** full/empty. No locks, no allocation after ingest_init().
+*/
+
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "data.h"
+
+#define INGEST_MAX_PRODUCERS 8
+#define INGEST_RING_CAP      4096               /* per producer, power of 2 */
+#define INGEST_RING_MASK     (INGEST_RING_CAP - 1)
+#define INGEST_BURST         256                /* events per ring per pass */
+#define INGEST_NAME_LEN      16
+#define INGEST_CACHE_LINE    64
+
+/* ---- Event Types ---- */
+typedef enum {
+  INGEST_PRICE,     /* market data: new mark + carry accrual  */
+  INGEST_TRADE,     /* trade drop copy: fill qty @ px         */
+  INGEST_RISK       /* risk engine: full sensitivity refresh  */
+} IngestKind;
+
+/* ---- Single Event (one cache line) ---- */
+typedef struct {
+  uint32_t kind;        /* IngestKind                           */
+  int32_t  pos;         /* index into PositionBook.items        */
+  uint32_t src;         /* producer id   — stamped by push      */
+  uint32_t seq;         /* per-producer sequence — stamped      */
+  union {
+    struct { double px;  double carry; } price;
+    struct { double qty; double px;    } trade;
+    PositionRisk risk;
+  };
+} IngestEvent;
+
+/* ---- SPSC Ring ---- */
+typedef struct {
+  /* producer-owned line */
+  _Alignas(INGEST_CACHE_LINE) _Atomic uint32_t head;
+  uint32_t tail_cache;          /* producer's last view of tail       */
+  uint32_t next_seq;
+  uint64_t pushed;
+  uint64_t stalls;              /* pushes rejected because ring full  */
+
+  /* consumer-owned line */
+  _Alignas(INGEST_CACHE_LINE) _Atomic uint32_t tail;
+  uint32_t head_cache;          /* consumer's last view of head       */
+  uint64_t applied;
+
+  _Alignas(INGEST_CACHE_LINE) IngestEvent slots[INGEST_RING_CAP];
+} IngestRing;
+
+/* ---- Hub: one ring per producer ---- */
+typedef struct {
+  IngestRing rings[INGEST_MAX_PRODUCERS];
+  char       names[INGEST_MAX_PRODUCERS][INGEST_NAME_LEN];
+  int        n_producers;
+  uint64_t   rejected;          /* events naming a nonexistent position */
+} IngestHub;
+
+/* ---- Reset hub (no producers registered) ---- */
+void ingest_init(IngestHub *hub);
+
+/* ---- Register a producer before its thread starts. Returns id or -1. ---- */
+int  ingest_register(IngestHub *hub, const char *name);
+
+/* ---- Producer side: publish one event. Returns 0 if the ring is full. ---- */
+int  ingest_push(IngestHub *hub, int producer, const IngestEvent *ev);
+
+/* ---- Consumer side: apply up to budget events. Returns count applied. ---- */
+int  ingest_drain(IngestHub *hub, PositionBook *book, int budget);
+
+/* ---- Apply a single event to the book (consumer thread only) ---- */
+void ingest_apply(IngestHub *hub, PositionBook *book, const IngestEvent *ev);
+
+#endif
@@ -0,0 +1,189 @@
+/*
+** ladder.c — DV01 Ladders (bucketed risk per group, delta-maintained)
+*/
+
+#include <string.h>
+#include "ladder.h"
+#include "agg.h"
+#include "sel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LADDER_X86 1
+#include <immintrin.h>
+#else
+#define LADDER_X86 0
+#endif
+
+/* Selection word k: sel[k], or "all rows" (tail-masked) when sel is NULL */
+static inline uint64_t sel_word(const uint64_t *sel, int k, int n) {
+  if (sel) return sel[k];
+  int left = n - k * 64;
+  return (left >= 64) ? ~0ull : ((1ull << left) - 1);
+}
+
+
+/* ============================================================================
+**  Kernels — one row's 16 buckets at a time
+** ============================================================================*/
+
+static void add_scalar(LadderVec *acc, const float *row) {
+  for (int b = 0; b < LADDER_BUCKETS; b++) acc->b[b] += (double)row[b];
+}
+
+/* lad += now - last, total likewise; last = now */
+static void move_scalar(LadderVec *lad, LadderVec *total, const float *now, float *last) {
+  for (int b = 0; b < LADDER_BUCKETS; b++) {
+    double d = (double)now[b] - (double)last[b];
+    lad->b[b]   += d;
+    total->b[b] += d;
+    last[b] = now[b];
+  }
+}
+
+#if LADDER_X86
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static void add_avx2(LadderVec *acc, const float *row) {
+  for (int b = 0; b < LADDER_BUCKETS; b += 4) {
+    __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(row + b));
+    _mm256_store_pd(acc->b + b, _mm256_add_pd(_mm256_load_pd(acc->b + b), x));
+  }
+}
+
+AVX2 static void move_avx2(LadderVec *lad, LadderVec *total, const float *now, float *last) {
+  for (int b = 0; b < LADDER_BUCKETS; b += 4) {
+    __m128  n4 = _mm_loadu_ps(now + b);
+    __m256d d  = _mm256_sub_pd(_mm256_cvtps_pd(n4), _mm256_cvtps_pd(_mm_loadu_ps(last + b)));
+    _mm256_store_pd(lad->b + b,   _mm256_add_pd(_mm256_load_pd(lad->b + b), d));
+    _mm256_store_pd(total->b + b, _mm256_add_pd(_mm256_load_pd(total->b + b), d));
+    _mm_storeu_ps(last + b, n4);
+  }
+}
+
+AVX2 static void sum_avx2(LadderVec *acc, const float (*rows)[LADDER_BUCKETS],
+                          const uint64_t *sel, int n)
+{
+  __m256d s0 = _mm256_load_pd(acc->b),     s1 = _mm256_load_pd(acc->b + 4);
+  __m256d s2 = _mm256_load_pd(acc->b + 8), s3 = _mm256_load_pd(acc->b + 12);
+  for (int k = 0, words = SEL_WORDS(n); k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    while (w) {
+      const float *r = rows[k * 64 + __builtin_ctzll(w)];
+      s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm_loadu_ps(r)));
+      s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm_loadu_ps(r + 4)));
+      s2 = _mm256_add_pd(s2, _mm256_cvtps_pd(_mm_loadu_ps(r + 8)));
+      s3 = _mm256_add_pd(s3, _mm256_cvtps_pd(_mm_loadu_ps(r + 12)));
+      w &= w - 1;
+    }
+  }
+  _mm256_store_pd(acc->b,      s0);
+  _mm256_store_pd(acc->b + 4,  s1);
+  _mm256_store_pd(acc->b + 8,  s2);
+  _mm256_store_pd(acc->b + 12, s3);
+}
+
+#endif
+
+static void add_row(LadderVec *acc, const float *row) {
+#if LADDER_X86
+  if (agg_simd_active()) { add_avx2(acc, row); return; }
+#endif
+  add_scalar(acc, row);
+}
+
+static void move_row(LadderVec *lad, LadderVec *total, const float *now, float *last) {
+#if LADDER_X86
+  if (agg_simd_active()) { move_avx2(lad, total, now, last); return; }
+#endif
+  move_scalar(lad, total, now, last);
+}
+
+
+void ladder_sum(LadderVec *acc, const float (*rows)[LADDER_BUCKETS], const uint64_t *sel, int n) {
+#if LADDER_X86
+  if (agg_simd_active()) { sum_avx2(acc, rows, sel, n); return; }
+#endif
+  for (int k = 0, words = SEL_WORDS(n); k < words; k++) {
+    uint64_t w = sel_word(sel, k, n);
+    while (w) {
+      add_scalar(acc, rows[k * 64 + __builtin_ctzll(w)]);
+      w &= w - 1;
+    }
+  }
+}
+
+
+double ladder_total(const LadderVec *v) {
+  double s = 0;
+  for (int b = 0; b < LADDER_BUCKETS; b++) s += v->b[b];
+  return s;
+}
+
+
+/* ============================================================================
+**  Ladder Set
+** ============================================================================*/
+
+/* Ladder index for key, appending on first sight (rebuilds only) */
+static int ladder_of(LadderSet *ls, uint32_t key) {
+  for (int i = 0; i < ls->count; i++) {
+    if (ls->keys[i] == key) return i;
+  }
+  int i = ls->count++;
+  ls->keys[i] = key;
+  ls->rows[i] = 0;
+  memset(&ls->ladders[i], 0, sizeof(ls->ladders[i]));
+  return i;
+}
+
+static void rebuild(LadderSet *ls, const PositionBook *book) {
+  ls->count = 0;
+  memset(&ls->total, 0, sizeof(ls->total));
+  for (int k = 0, words = SEL_WORDS(book->count); k < words; k++) {
+    uint64_t w = ls->sel[k];
+    while (w) {
+      int row = k * 64 + __builtin_ctzll(w);
+      int li  = ladder_of(ls, group_row_key(&ls->by, book, row));
+      ls->of[row] = (uint8_t)li;
+      ls->rows[li]++;
+      add_row(&ls->ladders[li], book->ladder.dv01[row]);
+      memcpy(ls->last[row], book->ladder.dv01[row], sizeof(ls->last[row]));
+      w &= w - 1;
+    }
+  }
+  /* One masked pass for the total rather than a second fold of the groups */
+  ladder_sum(&ls->total, (const float (*)[LADDER_BUCKETS])book->ladder.dv01, ls->sel, book->count);
+  ls->base_epoch = book->value_epoch;
+  ls->rebuilds++;
+}
+
+
+void ladder_sync(LadderSet *ls, const GroupSpec *by, const uint64_t *sel,
+                 const PositionBook *book)
+{
+  uint64_t want[SEL_WORDS(MAX_POSITIONS)] = { 0 };
+  if (sel) sel_copy(want, sel, book->count);
+  else     sel_fill(want, book->count);
+
+  unsigned behind = book->value_epoch - ls->value_epoch;
+  int same = ls->valid && ls->book == book && ls->struct_epoch == book->struct_epoch &&
+             group_spec_eq(&ls->by, by) && memcmp(ls->sel, want, sizeof(want)) == 0;
+  if (same && behind == 0) return;
+
+  if (!same || behind > BOOK_LOG_LEN || book->value_epoch - ls->base_epoch >= BOOK_REBASE_EPOCHS) {
+    ls->by = *by;
+    memcpy(ls->sel, want, sizeof(want));
+    rebuild(ls, book);
+  } else {
+    for (unsigned e = ls->value_epoch; e != book->value_epoch; e++) {
+      int row = book->log.rows[e % BOOK_LOG_LEN];
+      if (!sel_test(ls->sel, row)) continue;
+      move_row(&ls->ladders[ls->of[row]], &ls->total, book->ladder.dv01[row], ls->last[row]);
+    }
+  }
+  ls->book         = book;
+  ls->struct_epoch = book->struct_epoch;
+  ls->value_epoch  = book->value_epoch;
+  ls->valid        = 1;
+}
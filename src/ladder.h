@@ -0,0 +1,66 @@
+/*
+** ladder.h — DV01 Ladders (bucketed risk per group, delta-maintained)
+**
+** Sums the book's bucketed DV01 (BookLadder: 16 floats a row) into one
+** ladder per group of a selection — per book, desk, currency, whatever
+** GroupSpec says — plus the selection's own ladder. Sums are double; the
+** kernels add a row's 16 buckets at once (AVX2: four 4-lane double adds
+** fed by float-to-double conversions, picked at runtime like agg.h's;
+** scalar elsewhere or when agg_force_scalar() is on).
+**
+** A LadderSet remembers what each row last contributed. Ticks replayed
+** from the book's journal (BookLog) move a row's ladder and the total by
+** new - old, so one position's sensitivities changing costs one 16-wide
+** subtract-and-add, whatever the book size. A changed selection,
+** grouping or set of rows rebuilds from one masked pass over the book,
+** as does every BOOK_REBASE_EPOCHS edits, dropping the rounding the
+** deltas picked up.
+*/
+
+#ifndef LADDER_H
+#define LADDER_H
+
+#include <stdint.h>
+#include "data.h"
+#include "group.h"
+
+typedef struct {
+  _Alignas(32) double b[LADDER_BUCKETS];
+} LadderVec;
+
+typedef struct {
+  LadderVec  ladders[GROUP_MAX];            /* first-appearance order */
+  uint32_t   keys[GROUP_MAX];               /* group key of each ladder */
+  int        rows[GROUP_MAX];               /* rows in each ladder */
+  int        count;
+  LadderVec  total;                         /* the whole selection */
+  uint8_t    of[MAX_POSITIONS];             /* ladder of each selected row */
+  _Alignas(64) float last[MAX_POSITIONS][LADDER_BUCKETS];  /* row's contribution */
+
+  /* What it was built for */
+  GroupSpec  by;
+  uint64_t   sel[SEL_WORDS(MAX_POSITIONS)];
+  const PositionBook *book;
+  unsigned   struct_epoch;
+  unsigned   value_epoch;                   /* journal replayed up to */
+  unsigned   base_epoch;                    /* value_epoch of the last rebuild */
+  unsigned   rebuilds;
+  int        valid;
+} LadderSet;
+
+/*
+** ---- Bring ls up to date: one ladder per group (by) of the rows in sel ----
+** sel == NULL means every row. Rebuilds when by, sel or the book's rows
+** changed, the journal overran or BOOK_REBASE_EPOCHS went by; otherwise
+** applies only the rows edited since the last call.
+*/
+void ladder_sync(LadderSet *ls, const GroupSpec *by, const uint64_t *sel,
+                 const PositionBook *book);
+
+/* ---- acc += every row of rows[0, n) in sel (NULL: all n) ---- */
+void ladder_sum(LadderVec *acc, const float (*rows)[LADDER_BUCKETS], const uint64_t *sel, int n);
+
+/* ---- Sum of a ladder's buckets (the scalar DV01 it breaks down) ---- */
+double ladder_total(const LadderVec *v);
+
+#endif
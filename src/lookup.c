@@ -0,0 +1,246 @@
+/*
+** lookup.c — Instrument Lookup (prefix index + fuzzy ranking)
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "lookup.h"
+#include "strmatch.h"
+
+#define LK_TOKEN_LEN 32
+
+/* Match quality per token, best first */
+#define LK_SCORE_HEAD   100         /* prefix of the key itself */
+#define LK_SCORE_WORD    60         /* prefix of a later word   */
+#define LK_SCORE_SUB     25         /* substring anywhere       */
+#define LK_SCORE_FUZZY    5         /* in-order subsequence     */
+
+static inline int is_alnum(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+static inline int word_start(const char *s, int i) {
+  return is_alnum(s[i]) && (i == 0 || !is_alnum(s[i - 1]));
+}
+
+
+/* ============================================================================
+**  Build
+** ============================================================================*/
+
+void lk_init(Lookup *lk, char *text, int text_cap, LkKey *keys, int keys_cap,
+             LkWord *words, int words_cap)
+{
+  lk->text  = text;   lk->text_cap  = text_cap;
+  lk->keys  = keys;   lk->keys_cap  = keys_cap;
+  lk->words = words;  lk->words_cap = words_cap;
+  lk_reset(lk);
+}
+
+
+void lk_reset(Lookup *lk) {
+  lk->text_len = 0;
+  lk->nkeys    = 0;
+  lk->nwords   = 0;
+  lk->sorted   = 1;
+}
+
+
+static uint64_t prefix8(const char *s) {
+  uint64_t v = 0;
+  int i = 0;
+  for (; i < 8 && s[i]; i++) v = (v << 8) | (uint8_t)s[i];
+  return v << (8 * (8 - i));
+}
+
+
+int lk_add(Lookup *lk, const char *s, int id, int kind) {
+  int len = (int)strlen(s);
+  if (len > UINT16_MAX) len = UINT16_MAX;
+
+  /* The arena keeps SM_PAD spare bytes past the last key for sm_find() */
+  if (lk->nkeys >= lk->keys_cap ||
+      lk->text_len + len + 1 + SM_PAD > lk->text_cap) return -1;
+
+  int words = 0;
+  for (int i = 0; i < len; i++) words += word_start(s, i);
+  if (lk->nwords + words > lk->words_cap) return -1;
+
+  char *t = lk->text + lk->text_len;
+  sm_lower(t, len + 1, s);
+  memset(t + len + 1, 0, SM_PAD);
+
+  LkKey *k = &lk->keys[lk->nkeys];
+  k->off  = (uint32_t)lk->text_len;
+  k->id   = (uint32_t)id;
+  k->len  = (uint16_t)len;
+  k->kind = (uint8_t)kind;
+
+  for (int i = 0; i < len; i++) {
+    if (!word_start(t, i)) continue;
+    LkWord *w = &lk->words[lk->nwords++];
+    w->pre = prefix8(t + i);
+    w->off = k->off + (uint32_t)i;
+    w->key = (uint32_t)lk->nkeys;
+  }
+
+  lk->nkeys++;
+  lk->text_len += len + 1;
+  lk->sorted = 0;
+  return 0;
+}
+
+
+/* qsort has no context argument; lk_finish() is not reentrant */
+static const char *s_sort_text;
+
+static int cmp_word(const void *pa, const void *pb) {
+  const LkWord *a = pa, *b = pb;
+  if (a->pre != b->pre) return (a->pre < b->pre) ? -1 : 1;
+  return strcmp(s_sort_text + a->off, s_sort_text + b->off);
+}
+
+
+void lk_finish(Lookup *lk) {
+  if (lk->sorted) return;
+  s_sort_text = lk->text;
+  qsort(lk->words, (size_t)lk->nwords, sizeof(LkWord), cmp_word);
+  lk->sorted = 1;
+}
+
+
+/* ============================================================================
+**  Query
+** ============================================================================*/
+
+/* First word whose text compares >= (upper: >) tok on tok's length */
+static int bound(const Lookup *lk, const char *tok, int tlen, int upper) {
+  int lo = 0, hi = lk->nwords;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    int c = strncmp(lk->text + lk->words[mid].off, tok, (size_t)tlen);
+    if (c < 0 || (upper && c == 0)) lo = mid + 1;
+    else                            hi = mid;
+  }
+  return lo;
+}
+
+
+static int subsequence(const char *s, int len, const char *tok, int tlen) {
+  int j = 0;
+  for (int i = 0; i < len && j < tlen; i++) j += (s[i] == tok[j]);
+  return j == tlen;
+}
+
+
+/* Sum of per-token match quality, scaled so shorter keys win ties;
+   -1 if any token doesn't match at all */
+static int score_key(const char *s, int len, char tok[][LK_TOKEN_LEN],
+                     const int *tlen, int nt)
+{
+  int score = 0;
+  for (int t = 0; t < nt; t++) {
+    const char *tk = tok[t];
+    int tl = tlen[t], best = 0;
+
+    if (tl <= len && memcmp(s, tk, (size_t)tl) == 0) {
+      best = LK_SCORE_HEAD;
+    } else if (sm_find(s, len, tk, tl)) {
+      best = LK_SCORE_SUB;
+      for (int i = 1; i + tl <= len; i++) {
+        if (word_start(s, i) && memcmp(s + i, tk, (size_t)tl) == 0) {
+          best = LK_SCORE_WORD;
+          break;
+        }
+      }
+    } else if (subsequence(s, len, tk, tl)) {
+      best = LK_SCORE_FUZZY;
+    } else {
+      return -1;
+    }
+    score += best;
+  }
+  return score * 1024 - len;
+}
+
+
+/* Insert h into the descending top-k list, one entry per id */
+static void offer(LkHit *out, int *n, int k, LkHit h) {
+  for (int i = 0; i < *n; i++) {
+    if (out[i].id != h.id) continue;
+    if (h.score <= out[i].score) return;
+    memmove(&out[i], &out[i + 1], sizeof(LkHit) * (size_t)(*n - i - 1));
+    (*n)--;
+    break;
+  }
+  if (*n == k && h.score <= out[k - 1].score) return;
+
+  int at = (*n < k) ? (*n)++ : k - 1;
+  while (at > 0 && out[at - 1].score < h.score) {
+    out[at] = out[at - 1];
+    at--;
+  }
+  out[at] = h;
+}
+
+
+int lk_query(const Lookup *lk, const char *q, LkHit *out, int k) {
+  if (k > LK_MAX_HITS) k = LK_MAX_HITS;
+  if (k <= 0 || !lk->sorted) return 0;
+
+  /* Tokenize (lowercased, split on spaces) and rejoin as a phrase */
+  char tok[LK_MAX_TOKENS][LK_TOKEN_LEN];
+  int  tlen[LK_MAX_TOKENS];
+  char phrase[LK_MAX_TOKENS * LK_TOKEN_LEN];
+  int  nt = 0, plen = 0, longest = 0;
+  for (const char *p = q; *p && nt < LK_MAX_TOKENS; ) {
+    while (*p == ' ') p++;
+    int l = 0;
+    while (p[l] && p[l] != ' ') l++;
+    if (!l) break;
+    char raw[LK_TOKEN_LEN];
+    int  cut = (l < LK_TOKEN_LEN) ? l : LK_TOKEN_LEN - 1;
+    memcpy(raw, p, (size_t)cut);
+    raw[cut] = '\0';
+    tlen[nt] = sm_lower(tok[nt], LK_TOKEN_LEN, raw);
+    if (plen) phrase[plen++] = ' ';
+    memcpy(phrase + plen, tok[nt], (size_t)tlen[nt]);
+    plen += tlen[nt];
+    if (tlen[nt] > tlen[longest]) longest = nt;
+    nt++;
+    p += l;
+  }
+  if (!nt) return 0;
+
+  /* Candidate range, most selective first: words continuing with the
+     whole phrase ("sofr 5y"), else the narrowest single-token range, else
+     the longest token shortened until something starts with it */
+  int lo = bound(lk, phrase, plen, 0);
+  int hi = bound(lk, phrase, plen, 1);
+  if (lo == hi && nt > 1) {
+    int best = -1;
+    for (int t = 0; t < nt; t++) {
+      int a = bound(lk, tok[t], tlen[t], 0);
+      int b = bound(lk, tok[t], tlen[t], 1);
+      if (a < b && (best < 0 || b - a < hi - lo)) {
+        best = t;
+        lo = a;
+        hi = b;
+      }
+    }
+  }
+  for (int alen = tlen[longest] - 1; lo == hi && alen > 0; alen--) {
+    lo = bound(lk, tok[longest], alen, 0);
+    hi = bound(lk, tok[longest], alen, 1);
+  }
+  if (hi - lo > LK_SCAN_MAX) hi = lo + LK_SCAN_MAX;
+
+  int n = 0;
+  for (int w = lo; w < hi; w++) {
+    const LkKey *key = &lk->keys[lk->words[w].key];
+    int s = score_key(lk->text + key->off, key->len, tok, tlen, nt);
+    if (s < 0) continue;
+    offer(out, &n, k, (LkHit){ (int)lk->words[w].key, (int)key->id, s });
+  }
+  return n;
+}
@@ -0,0 +1,80 @@
+/*
+** lookup.h — Instrument Lookup (prefix index + fuzzy ranking)
+**
+** Type-ahead over instrument names and identifiers: "ust 10" or a partial
+** CUSIP returns the best few instruments while the user types.
+**
+** Every indexed string (a key) is lowercased into one flat text arena.
+** Each word start inside a key ("ust 10y 3.875 11/34" has ust, 10y, 3,
+** 875, 11, 34) gets an entry in a sorted prefix array, so all keys with a
+** word beginning with a given prefix form one contiguous range found by
+** binary search — O(log n) on a universe of millions.
+**
+** A query is split into tokens. Candidates come from one range (capped
+** at LK_SCAN_MAX): words continuing with the whole query ("sofr 5y"
+** matches "...sofr 5y irs"), else the narrowest single-token range, else
+** — nothing starts with any token (a typo, "ust10") — the longest token
+** shortened until something does. Each candidate is then scored on all
+** tokens: match at the head of the key > word-start match > substring >
+** fuzzy in-order subsequence; a token matching none of these rejects the
+** key. Shorter keys win ties. Hits are de-duplicated per id (an instrument's
+** name and CUSIP are separate keys with the same id).
+**
+** Storage is supplied by the caller (static arrays for the book, heap
+** for a large universe); nothing here allocates.
+*/
+
+#ifndef LOOKUP_H
+#define LOOKUP_H
+
+#include <stdint.h>
+
+#define LK_MAX_TOKENS 8
+#define LK_MAX_HITS   16
+#define LK_SCAN_MAX   4096          /* candidates scored per query */
+
+/* ---- One indexed string ---- */
+typedef struct {
+  uint32_t  off;                    /* into text */
+  uint32_t  id;                     /* caller's id (row, instrument) */
+  uint16_t  len;
+  uint8_t   kind;                   /* caller's tag (name, cusip, ...) */
+} LkKey;
+
+/* ---- One word start; sorted by the text from off to the key's end ---- */
+typedef struct {
+  uint64_t  pre;                    /* first 8 bytes, big-endian (sort key) */
+  uint32_t  off;
+  uint32_t  key;
+} LkWord;
+
+typedef struct {
+  char     *text;   int text_len,  text_cap;
+  LkKey    *keys;   int nkeys,     keys_cap;
+  LkWord   *words;  int nwords,    words_cap;
+  int       sorted;                 /* lk_finish() since last lk_add() */
+} Lookup;
+
+typedef struct {
+  int  key;                         /* index into keys */
+  int  id;
+  int  score;
+} LkHit;
+
+/* ---- Attach caller storage and empty the index ---- */
+void lk_init(Lookup *lk, char *text, int text_cap, LkKey *keys, int keys_cap,
+             LkWord *words, int words_cap);
+
+/* ---- Drop all keys, keeping the storage ---- */
+void lk_reset(Lookup *lk);
+
+/* ---- Index s under id. Returns 0, or -1 if the storage is full. ---- */
+int  lk_add(Lookup *lk, const char *s, int id, int kind);
+
+/* ---- Sort the prefix array; call after adding, before querying ---- */
+void lk_finish(Lookup *lk);
+
+/* ---- Top-k (k <= LK_MAX_HITS) matches for q, best first. Returns count. ---- */
+int  lk_query(const Lookup *lk, const char *q, LkHit *out, int k);
+
+#endif
@@ -0,0 +1,184 @@
+/*
+** movers.c — Top-N Movers (bounded heaps, lazy invalidation)
+*/
+
+#include <string.h>
+#include "movers.h"
+
+static const char *const MOVERS_LABEL[MOVERS_COUNT] = {
+  "DAY P&L LOSERS", "DAY P&L GAINERS", "LARGEST DV01"
+};
+
+const char *movers_label(MoversKind k) {
+  return MOVERS_LABEL[k];
+}
+
+
+/* Score of row for k; only rows scoring above 0 are ranked at all */
+static double score_of(const PositionBook *book, MoversKind k, int row) {
+  switch (k) {
+    case MOVERS_LOSERS:  return -book->cols.f64[FIELD_PNL_DAY][row];
+    case MOVERS_GAINERS: return  book->cols.f64[FIELD_PNL_DAY][row];
+    default: {
+      double d = book->cols.f64[FIELD_DV01][row];
+      return d < 0 ? -d : d;
+    }
+  }
+}
+
+
+/* ============================================================================
+**  Heap
+** ============================================================================*/
+
+static inline int entry_valid(const MoversHeap *h, const MoversEntry *e) {
+  return e->ver == h->ver[e->row];
+}
+
+static void sift_up(MoversHeap *h, int i) {
+  MoversEntry e = h->heap[i];
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (h->heap[parent].score <= e.score) break;
+    h->heap[i] = h->heap[parent];
+    i = parent;
+  }
+  h->heap[i] = e;
+}
+
+static void sift_down(MoversHeap *h, int i) {
+  MoversEntry e = h->heap[i];
+  for (;;) {
+    int c = 2 * i + 1;
+    if (c >= h->size) break;
+    if (c + 1 < h->size && h->heap[c + 1].score < h->heap[c].score) c++;
+    if (e.score <= h->heap[c].score) break;
+    h->heap[i] = h->heap[c];
+    i = c;
+  }
+  h->heap[i] = e;
+}
+
+static void pop_root(MoversHeap *h) {
+  h->heap[0] = h->heap[--h->size];
+  if (h->size) sift_down(h, 0);
+}
+
+/* Drop every stale entry and re-heapify: O(MOVERS_CAP) */
+static void compact(MoversHeap *h) {
+  int n = 0;
+  for (int i = 0; i < h->size; i++) {
+    if (entry_valid(h, &h->heap[i])) h->heap[n++] = h->heap[i];
+  }
+  h->size  = n;
+  h->stale = 0;
+  for (int i = n / 2 - 1; i >= 0; i--) sift_down(h, i);
+}
+
+static void push(MoversHeap *h, int row, double score) {
+  if (h->size == MOVERS_CAP && h->stale * 2 >= MOVERS_CAP) compact(h);
+  while (h->size == MOVERS_CAP && !entry_valid(h, &h->heap[0])) {
+    pop_root(h);
+    h->stale--;
+  }
+
+  MoversEntry e = { score, h->ver[row], (uint16_t)row };
+  if (h->size == MOVERS_CAP) {
+    MoversEntry *root = &h->heap[0];
+    if (root->score >= score) {
+      if (score > h->floor) h->floor = score;
+      return;
+    }
+    if (root->score > h->floor) h->floor = root->score;
+    h->in[root->row] = 0;
+    *root = e;
+    sift_down(h, 0);
+  } else {
+    h->heap[h->size++] = e;
+    sift_up(h, h->size - 1);
+  }
+  h->in[row] = 1;
+}
+
+/* Row moved to score: invalidate its entry in place, re-push if it ranks */
+static void update(MoversHeap *h, int row, double score) {
+  if (h->in[row]) {
+    h->in[row] = 0;
+    h->stale++;
+  }
+  h->ver[row]++;
+  if (score > h->floor) push(h, row, score);
+}
+
+static void rebuild(MoversHeap *h, const PositionBook *book, MoversKind k) {
+  h->size  = 0;
+  h->stale = 0;
+  h->floor = 0;
+  memset(h->in, 0, sizeof(h->in));
+  for (int i = 0; i < book->count; i++) {
+    double s = score_of(book, k, i);
+    if (s > h->floor) push(h, i, s);
+  }
+  h->rebuilds++;
+}
+
+
+/* ============================================================================
+**  Tracker
+** ============================================================================*/
+
+void movers_sync(Movers *m, const PositionBook *book) {
+  unsigned behind = book->value_epoch - m->value_epoch;
+  if (m->valid && m->book == book && behind == 0) return;
+
+  if (!m->valid || m->book != book || behind > BOOK_LOG_LEN) {
+    for (int k = 0; k < MOVERS_COUNT; k++) rebuild(&m->top[k], book, (MoversKind)k);
+  } else {
+    for (unsigned e = m->value_epoch; e != book->value_epoch; e++) {
+      int row = book->log.rows[e % BOOK_LOG_LEN];
+      for (int k = 0; k < MOVERS_COUNT; k++) {
+        update(&m->top[k], row, score_of(book, (MoversKind)k, row));
+      }
+    }
+  }
+  m->book        = book;
+  m->value_epoch = book->value_epoch;
+  m->valid       = 1;
+}
+
+
+/* Valid entries at or above the floor, best first (ties: lower row) */
+static int collect(const MoversHeap *h, MoversEntry *out) {
+  int n = 0;
+  for (int i = 0; i < h->size; i++) {
+    const MoversEntry *e = &h->heap[i];
+    if (!entry_valid(h, e) || e->score < h->floor) continue;
+    int at = n++;
+    while (at > 0 && (out[at - 1].score < e->score ||
+                      (out[at - 1].score == e->score && out[at - 1].row > e->row))) {
+      out[at] = out[at - 1];
+      at--;
+    }
+    out[at] = *e;
+  }
+  return n;
+}
+
+
+int movers_top(Movers *m, const PositionBook *book, MoversKind k, int *rows, int n) {
+  if (n > MOVERS_N) n = MOVERS_N;
+  movers_sync(m, book);
+
+  MoversHeap *h = &m->top[k];
+  MoversEntry best[MOVERS_CAP];
+  int got = collect(h, best);
+
+  /* A floor above 0 means ranked rows may sit outside the heap */
+  if (got < n && h->floor > 0) {
+    rebuild(h, book, k);
+    got = collect(h, best);
+  }
+  if (got > n) got = n;
+  for (int i = 0; i < got; i++) rows[i] = best[i].row;
+  return got;
+}
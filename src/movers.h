@@ -0,0 +1,75 @@
+/*
+** movers.h — Top-N Movers (bounded heaps, lazy invalidation)
+**
+** Keeps the best MOVERS_N rows of the book per metric (day P&L losers,
+** gainers, largest |DV01|) current as positions tick, without sorting the
+** book. Each metric holds a min-heap of at most MOVERS_CAP candidates —
+** the root is the weakest — and a floor: no row outside the heap scores
+** above it.
+**
+** A tick on row r bumps r's version, which invalidates whatever heap
+** entry r had in place (it's skipped, and dropped once it reaches the
+** root or the heap is compacted). If r's new score beats the floor it is
+** pushed, evicting the root when the heap is full and raising the floor
+** to the evicted score. So an update costs O(log MOVERS_CAP) whatever the
+** book size. Ticks are read from the book's journal (BookLog).
+**
+** Reading the top N takes the valid entries scoring at or above the
+** floor — those provably beat every row outside. If that leaves fewer
+** than N (too many members fell back since the last rebuild), the metric
+** is rebuilt from one scan of the book.
+*/
+
+#ifndef MOVERS_H
+#define MOVERS_H
+
+#include <stdint.h>
+#include "data.h"
+
+#define MOVERS_N   20
+#define MOVERS_CAP (2 * MOVERS_N)       /* top N plus slack for drop-outs */
+
+typedef enum {
+  MOVERS_LOSERS,                        /* most negative day P&L */
+  MOVERS_GAINERS,                       /* most positive day P&L */
+  MOVERS_DV01,                          /* largest |DV01| */
+  MOVERS_COUNT
+} MoversKind;
+
+typedef struct {
+  double    score;                      /* higher ranks first */
+  uint32_t  ver;                        /* row's version when pushed */
+  uint16_t  row;
+} MoversEntry;
+
+typedef struct {
+  MoversEntry heap[MOVERS_CAP];         /* min-heap on score */
+  int         size;
+  int         stale;                    /* entries whose row has moved on */
+  double      floor;
+  uint32_t    ver[MAX_POSITIONS];       /* per-row version */
+  uint8_t     in[MAX_POSITIONS];        /* row has a valid entry */
+  unsigned    rebuilds;
+} MoversHeap;
+
+typedef struct {
+  MoversHeap  top[MOVERS_COUNT];
+  const PositionBook *book;
+  unsigned    value_epoch;              /* journal replayed up to */
+  int         valid;
+} Movers;
+
+/* ---- Metric label ("DAY P&L LOSERS", ...) ---- */
+const char *movers_label(MoversKind k);
+
+/* ---- Replay the book's edits since the last call (rebuilds if too far behind) ---- */
+void movers_sync(Movers *m, const PositionBook *book);
+
+/*
+** ---- Top rows for k, best first ----
+** Writes up to n (<= MOVERS_N) row indices and returns the count. Syncs
+** first; may rebuild k from the book.
+*/
+int  movers_top(Movers *m, const PositionBook *book, MoversKind k, int *rows, int n);
+
+#endif
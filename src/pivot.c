@@ -0,0 +1,247 @@
+/*
+** pivot.c — Pivot Cube (rows x columns x measures, delta-maintained)
+*/
+
+#include <string.h>
+#include "pivot.h"
+#include "agg.h"
+#include "sel.h"
+
+void pivot_reset(Pivot *pv) {
+  pv->ncells = pv->nrows = pv->ncols = 0;
+  memset(&pv->total, 0, sizeof(pv->total));
+  memset(pv->slots, 0, sizeof(uint32_t) << pv->slot_bits);
+  memset(pv->src_cell, 0, sizeof(uint32_t) * (size_t)pv->src_cap);
+}
+
+
+static inline uint32_t cell_hash(uint32_t rkey, uint32_t ckey, int bits) {
+  uint64_t k = (uint64_t)rkey << 32 | ckey;
+  return (uint32_t)((k * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+}
+
+/* Slot of (rkey, ckey): holding it, or the empty one it would go in */
+static uint32_t cell_slot(const Pivot *pv, uint32_t rkey, uint32_t ckey) {
+  uint32_t mask = (1u << pv->slot_bits) - 1;
+  uint32_t h = cell_hash(rkey, ckey, pv->slot_bits);
+  for (;;) {
+    uint32_t s = pv->slots[h];
+    if (!s) return h;
+    const PivotCell *c = &pv->cells[s - 1];
+    if (c->rkey == rkey && c->ckey == ckey) return h;
+    h = (h + 1) & mask;
+  }
+}
+
+/* Head index for key, appending on first sight. Only a new cell comes
+   here, and axes are short (tens to hundreds), so a scan will do. */
+static int head_find_or_add(PivotHead *heads, int *n, int cap, uint32_t key) {
+  for (int i = 0; i < *n; i++) {
+    if (heads[i].key == key) return i;
+  }
+  if (*n == cap) return -1;
+  PivotHead *h = &heads[*n];
+  memset(h, 0, sizeof(*h));
+  h->key = key;
+  return (*n)++;
+}
+
+static PivotCell *cell_find_or_add(Pivot *pv, uint32_t rkey, uint32_t ckey) {
+  uint32_t at = cell_slot(pv, rkey, ckey);
+  if (pv->slots[at]) return &pv->cells[pv->slots[at] - 1];
+  if (pv->ncells == pv->cells_cap) return NULL;
+
+  int r = head_find_or_add(pv->rows, &pv->nrows, pv->rows_cap, rkey);
+  int c = head_find_or_add(pv->cols, &pv->ncols, pv->cols_cap, ckey);
+  if (r < 0 || c < 0) return NULL;
+
+  PivotCell *cell = &pv->cells[pv->ncells];
+  memset(cell, 0, sizeof(*cell));
+  cell->rkey = rkey;
+  cell->ckey = ckey;
+  cell->r    = r;
+  cell->c    = c;
+  pv->slots[at] = (uint32_t)++pv->ncells;
+  return cell;
+}
+
+
+int pivot_set_row(Pivot *pv, int src, uint32_t rkey, uint32_t ckey, const double *vals) {
+  if (src < 0 || src >= pv->src_cap) return -1;
+  int     nm   = pv->nmeasures;
+  double *last = &pv->src_vals[(size_t)src * (size_t)nm];
+  PivotCell *cell;
+
+  if (pv->src_cell[src]) {
+    cell = &pv->cells[pv->src_cell[src] - 1];
+  } else {
+    cell = cell_find_or_add(pv, rkey, ckey);
+    if (!cell) return -1;
+    pv->src_cell[src] = (uint32_t)(cell - pv->cells) + 1;
+    cell->count++;
+    pv->rows[cell->r].count++;
+    pv->cols[cell->c].count++;
+    pv->total.count++;
+    for (int m = 0; m < nm; m++) last[m] = 0;
+  }
+
+  PivotHead *row = &pv->rows[cell->r];
+  PivotHead *col = &pv->cols[cell->c];
+  for (int m = 0; m < nm; m++) {
+    double unit = pv->unit[m];
+    if (unit > 0) {
+      int64_t d = (int64_t)vals[m] - (int64_t)last[m];
+      cell->sum[m]     = (double)(cell->exact[m]     += d) * unit;
+      row->sum[m]      = (double)(row->exact[m]      += d) * unit;
+      col->sum[m]      = (double)(col->exact[m]      += d) * unit;
+      pv->total.sum[m] = (double)(pv->total.exact[m] += d) * unit;
+    } else {
+      double d = vals[m] - last[m];
+      cell->sum[m]      += d;
+      row->sum[m]       += d;
+      col->sum[m]       += d;
+      pv->total.sum[m]  += d;
+    }
+    last[m] = vals[m];
+  }
+  return 0;
+}
+
+
+const PivotCell* pivot_cell(const Pivot *pv, uint32_t rkey, uint32_t ckey) {
+  uint32_t s = pv->slots[cell_slot(pv, rkey, ckey)];
+  return s ? &pv->cells[s - 1] : NULL;
+}
+
+
+/* ============================================================================
+**  Position Book Pivot
+** ============================================================================*/
+
+static const char *const MEASURE_NAME[PIVOT_MEASURE_COUNT] = {
+  "DV01", "Vega", "Day P&L", "Notional"
+};
+
+static const NumField MEASURE_FIELD[PIVOT_MEASURE_COUNT] = {
+  FIELD_DV01, FIELD_VEGA, FIELD_PNL_DAY, FIELD_NOTIONAL
+};
+
+const char *pivot_measure_name(PivotMeasure m) {
+  return MEASURE_NAME[m];
+}
+
+
+static void bind(BookPivot *bp) {
+  Pivot *pv = &bp->pv;
+  pv->nmeasures = PIVOT_MEASURE_COUNT;
+#ifdef BBG_FIXED
+  /* Money measures arrive as storage values and are summed exactly */
+  pv->unit[PIVOT_PNL_DAY]  = FX_PNL_D(1);
+  pv->unit[PIVOT_NOTIONAL] = FX_NOTIONAL_D(1);
+#endif
+  pv->cells     = bp->cells;     pv->cells_cap = MAX_POSITIONS;
+  pv->slots     = bp->slots;     pv->slot_bits = BOOK_PIVOT_SLOT_BITS;
+  pv->rows      = bp->rows;      pv->rows_cap  = MAX_POSITIONS;
+  pv->cols      = bp->cols;      pv->cols_cap  = MAX_POSITIONS;
+  pv->src_cell  = bp->src_cell;
+  pv->src_vals  = bp->src_vals;
+  pv->src_cap   = MAX_POSITIONS;
+}
+
+/* Value of measure m for row, as the cube takes it */
+static double measure_val(const PositionBook *book, int m, int row) {
+#ifdef BBG_FIXED
+  if (MEASURE_FIELD[m] < FIELD_MONEY_COUNT) return (double)book->cols.fx[MEASURE_FIELD[m]][row];
+#endif
+  return book->cols.f64[MEASURE_FIELD[m]][row];
+}
+
+static void set_row(BookPivot *bp, const PositionBook *book, int row) {
+  double vals[PIVOT_MEASURE_COUNT];
+  for (int m = 0; m < PIVOT_MEASURE_COUNT; m++) vals[m] = measure_val(book, m, row);
+  /* Storage is sized for the whole book, so this cannot fail */
+  (void)pivot_set_row(&bp->pv, row,
+                      group_row_key(&bp->def.rows_by, book, row),
+                      group_row_key(&bp->def.cols_by, book, row), vals);
+}
+
+
+/* Rows of the book in cell, row head r and column head c (-1: any) */
+static void select_rows(uint64_t *sel, const Pivot *pv, int n, int cell, int r, int c) {
+  sel_clear(sel, n);
+  for (int row = 0; row < n; row++) {
+    int              ci = (int)pv->src_cell[row] - 1;
+    const PivotCell *pc = &pv->cells[ci];
+    if ((cell < 0 || ci == cell) && (r < 0 || pc->r == r) && (c < 0 || pc->c == c)) {
+      sel_set(sel, row);
+    }
+  }
+}
+
+/* Sums of every measure over the rows in sel (NULL: all) */
+static void sum_rows(const Pivot *pv, const PositionBook *book, const uint64_t *sel,
+                     double *sum, int64_t *exact)
+{
+#ifndef BBG_FIXED
+  (void)pv; (void)exact;                    /* no exact measures */
+#endif
+  for (int m = 0; m < PIVOT_MEASURE_COUNT; m++) {
+    NumField f = MEASURE_FIELD[m];
+#ifdef BBG_FIXED
+    if (f < FIELD_MONEY_COUNT) {
+      exact[m] = agg_sum_money(&book->cols, f, sel, book->count);
+      sum[m]   = (double)exact[m] * pv->unit[m];
+      continue;
+    }
+#endif
+    sum[m] = agg_sum(book->cols.f64[f], sel, book->count);
+  }
+}
+
+/* Place every row, then take each sum from the agg kernels rather than
+   the adds that placed it: one masked pass per cell, head and total */
+static void rebuild(BookPivot *bp, const PositionBook *book) {
+  Pivot   *pv = &bp->pv;
+  uint64_t sel[SEL_WORDS(MAX_POSITIONS)];
+  pivot_reset(pv);
+  for (int i = 0; i < book->count; i++) set_row(bp, book, i);
+  for (int i = 0; i < pv->ncells; i++) {
+    select_rows(sel, pv, book->count, i, -1, -1);
+    sum_rows(pv, book, sel, pv->cells[i].sum, pv->cells[i].exact);
+  }
+  for (int r = 0; r < pv->nrows; r++) {
+    select_rows(sel, pv, book->count, -1, r, -1);
+    sum_rows(pv, book, sel, pv->rows[r].sum, pv->rows[r].exact);
+  }
+  for (int c = 0; c < pv->ncols; c++) {
+    select_rows(sel, pv, book->count, -1, -1, c);
+    sum_rows(pv, book, sel, pv->cols[c].sum, pv->cols[c].exact);
+  }
+  sum_rows(pv, book, NULL, pv->total.sum, pv->total.exact);
+  bp->base_epoch = book->value_epoch;
+  bp->rebuilds++;
+}
+
+
+const Pivot* book_pivot_sync(BookPivot *bp, const PivotDef *def, const PositionBook *book) {
+  bind(bp);
+  unsigned behind = book->value_epoch - bp->value_epoch;
+  int same_def = group_spec_eq(&bp->def.rows_by, &def->rows_by) &&
+                 group_spec_eq(&bp->def.cols_by, &def->cols_by);
+  if (bp->valid && bp->book == book && same_def && behind == 0) return &bp->pv;
+
+  if (!bp->valid || bp->book != book || !same_def || behind > BOOK_LOG_LEN ||
+      book->value_epoch - bp->base_epoch >= BOOK_REBASE_EPOCHS) {
+    bp->def = *def;
+    rebuild(bp, book);
+  } else {
+    /* Appends are journalled too, so a new row is placed on first sight */
+    for (unsigned e = bp->value_epoch; e != book->value_epoch; e++) {
+      set_row(bp, book, book->log.rows[e % BOOK_LOG_LEN]);
+    }
+  }
+  bp->book        = book;
+  bp->value_epoch = book->value_epoch;
+  bp->valid       = 1;
+  return &bp->pv;
+}
@@ -0,0 +1,139 @@
+/*
+** pivot.h — Pivot Cube (rows x columns x measures, delta-maintained)
+**
+** A sparse 2-D aggregation: every source row lands in one cell, found by
+** its (row key, column key) pair, and contributes PIVOT_MAX_MEASURES or
+** fewer measure values. A key is any uint32 — in POMS a packed GroupSpec
+** key (group.h), so each axis can itself be up to three dimensions deep,
+** e.g. desk x asset class, or currency+book x asset class. Only occupied
+** cells exist; they live in an open-addressed hash table, so a cube of a
+** few thousand cells over a large book costs only what is occupied.
+**
+** Cells, row heads, column heads and the grand total are maintained by
+** delta: pivot_set_row() remembers what each source row last contributed,
+** so a tick on one position is O(measures) — subtract the old values, add
+** the new — whatever the book size. Keys of a source row are fixed once
+** it is added (categorical columns never change). A measure given a unit
+** takes integer multiples of it (fixed-point money) and is summed in
+** int64, so its deltas are exact; the others are double and drift by a
+** rounding error per tick until the owner rebuilds.
+**
+** Storage is supplied by the caller through the struct's pointer fields
+** (static arrays for the book, heap for a bench universe); nothing here
+** allocates. pivot_reset() empties the cube.
+**
+** BookPivot adapts the cube to the PositionBook: GroupSpec axes, a fixed
+** set of measures (DV01, vega, day P&L, notional — switching the one on
+** display is free), and ticks replayed from the book's journal. Its sums
+** are (re)based through the agg.h kernels, and every BOOK_REBASE_EPOCHS
+** edits; under BBG_FIXED day P&L and notional are exact int64 throughout.
+*/
+
+#ifndef PIVOT_H
+#define PIVOT_H
+
+#include <stdint.h>
+#include "data.h"
+#include "group.h"
+
+#define PIVOT_MAX_MEASURES 4
+
+typedef struct {
+  uint32_t  rkey, ckey;
+  int       r, c;                           /* index into rows / cols */
+  int       count;                          /* source rows in the cell */
+  double    sum[PIVOT_MAX_MEASURES];
+  int64_t   exact[PIVOT_MAX_MEASURES];      /* measures with a unit: sum / unit */
+} PivotCell;
+
+/* ---- One row or column of the cube, with its total ---- */
+typedef struct {
+  uint32_t  key;
+  int       count;
+  double    sum[PIVOT_MAX_MEASURES];
+  int64_t   exact[PIVOT_MAX_MEASURES];
+} PivotHead;
+
+typedef struct {
+  int        nmeasures;
+  double     unit[PIVOT_MAX_MEASURES];      /* > 0: values are integers of it */
+
+  /* Caller storage */
+  PivotCell *cells;     int cells_cap;
+  uint32_t  *slots;     int slot_bits;      /* 1 << slot_bits >= 2 * cells_cap */
+  PivotHead *rows;      int rows_cap;
+  PivotHead *cols;      int cols_cap;
+  uint32_t  *src_cell;                      /* per source row: cell + 1, 0 = absent */
+  double    *src_vals;                      /* per source row: nmeasures last added */
+  int        src_cap;
+
+  /* State */
+  int        ncells, nrows, ncols;
+  PivotHead  total;
+} Pivot;
+
+/* ---- Empty the cube (storage fields must be set) ---- */
+void pivot_reset(Pivot *pv);
+
+/*
+** ---- Add source row src, or move it to new measure values ----
+** First call for src places it in cell (rkey, ckey); later calls apply
+** the difference. For a measure with a unit, vals[m] is a whole count of
+** it (e.g. a fixed-point storage value); exact[m] sums the counts and
+** sum[m] is exact[m] * unit. Returns 0, or -1 if src or the cube is out
+** of storage.
+*/
+int  pivot_set_row(Pivot *pv, int src, uint32_t rkey, uint32_t ckey, const double *vals);
+
+/* ---- Cell (rkey, ckey), or NULL if no source row lands there ---- */
+const PivotCell* pivot_cell(const Pivot *pv, uint32_t rkey, uint32_t ckey);
+
+
+/* ============================================================================
+**  Position Book Pivot
+** ============================================================================*/
+
+typedef enum {
+  PIVOT_DV01,
+  PIVOT_VEGA,
+  PIVOT_PNL_DAY,
+  PIVOT_NOTIONAL,
+  PIVOT_MEASURE_COUNT
+} PivotMeasure;
+
+typedef struct {
+  GroupSpec  rows_by;
+  GroupSpec  cols_by;
+} PivotDef;
+
+#define BOOK_PIVOT_SLOT_BITS 8              /* 2 x MAX_POSITIONS cells */
+
+typedef struct {
+  PivotDef   def;                           /* what the cube is built on */
+  Pivot      pv;
+  PivotCell  cells[MAX_POSITIONS];
+  uint32_t   slots[1 << BOOK_PIVOT_SLOT_BITS];
+  PivotHead  rows[MAX_POSITIONS];
+  PivotHead  cols[MAX_POSITIONS];
+  uint32_t   src_cell[MAX_POSITIONS];
+  double     src_vals[MAX_POSITIONS * PIVOT_MAX_MEASURES];
+  const PositionBook *book;
+  unsigned   value_epoch;                   /* journal replayed up to */
+  unsigned   base_epoch;                    /* value_epoch of the last rebuild */
+  unsigned   rebuilds;
+  int        valid;
+} BookPivot;
+
+/* ---- Measure label ("DV01", ...) ---- */
+const char *pivot_measure_name(PivotMeasure m);
+
+/*
+** ---- Bring bp up to date with book for def ----
+** Rebuilds when the definition or book changed, the journal overran or
+** BOOK_REBASE_EPOCHS went by; otherwise applies only the rows edited
+** since the last call. Pointers
+** into bp are re-bound on every call, so a BookPivot may be copied.
+*/
+const Pivot* book_pivot_sync(BookPivot *bp, const PivotDef *def, const PositionBook *book);
+
+#endif
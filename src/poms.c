@@ -7,6 +7,9 @@
 #include "poms.h"
 #include "table.h"
 #include "theme.h"
+#include "fmt.h"
+#include "lookup.h"
+#include "strmatch.h"
 
 /* ---- Column Layout ---- */
 
@@ -36,47 +39,56 @@ static const char *COL_HDR[COL_COUNT] = {
   "DV01", "CS01", "DELTA", "VEGA", "THETA", "GAMMA"
 };
 
-#define ROW_H 18
-
-/* ---- Abbreviate book names to fit column ---- */
-static const char *book_short(const char *book) {
-  if (strcmp(book, "Rates Flow") == 0) return "FLOW";
-  if (strcmp(book, "Swaps")      == 0) return "SWAP";
-  if (strcmp(book, "Futures")    == 0) return "FUT";
-  if (strcmp(book, "Vol Desk")   == 0) return "VOL";
-  return book;
-}
-
-static const char *desk_short(const char *desk) {
-  if (strcmp(desk, "US Rates")  == 0) return "USR";
-  if (strcmp(desk, "EUR Rates") == 0) return "EUR";
-  if (strcmp(desk, "GBP Rates") == 0) return "GBP";
-  if (strcmp(desk, "USD Swaps") == 0) return "USDSW";
-  if (strcmp(desk, "EUR Swaps") == 0) return "EURSW";
-  if (strcmp(desk, "GBP Swaps") == 0) return "GBPSW";
-  if (strcmp(desk, "USD Vol")   == 0) return "USDVL";
-  if (strcmp(desk, "EUR Vol")   == 0) return "EURVL";
-  return desk;
-}
+/* Sort column behind each grid column */
+static const uint8_t COL_SORT[COL_COUNT] = {
+  SORT_INSTRUMENT, SORT_CUSIP, SORT_BOOK, SORT_DESK,
+  FIELD_NOTIONAL, FIELD_AVG_PRICE, FIELD_MKT_PRICE,
+  FIELD_PNL_TOTAL, FIELD_PNL_DAY,
+  FIELD_DV01, FIELD_CS01, FIELD_DELTA, FIELD_VEGA, FIELD_THETA, FIELD_GAMMA
+};
 
+#define ROW_H 18
 
 /* ---- Header Row ---- */
 
-static void draw_header(mu_Context *ctx) {
+/* Click sorts by the column (again: flips direction); shift-click adds it
+   as a further key. Sorted columns show ^ / v, plus the key's rank when
+   sorting on more than one. */
+static void draw_header(mu_Context *ctx, SortSpec *sort) {
   mu_layout_row(ctx, COL_COUNT, COL_W, ROW_H);
   for (int c = 0; c < COL_COUNT; c++) {
     mu_Rect r = mu_layout_next(ctx);
     mu_draw_rect(ctx, r, TH_HEADER_BG);
 
+    char id_buf[16];
+    snprintf(id_buf, sizeof(id_buf), "!hdr_%d", c);
+    mu_Id id = mu_get_id(ctx, id_buf, (int)strlen(id_buf));
+    mu_update_control(ctx, id, r, 0);
+    if (ctx->mouse_pressed == MU_MOUSE_LEFT && ctx->focus == id) {
+      sort_click(sort, COL_SORT[c], (ctx->key_down & MU_KEY_SHIFT) != 0);
+    }
+
+    char label[24];
+    int  at = sort_key_index(sort, COL_SORT[c]);
+    if (at < 0) {
+      snprintf(label, sizeof(label), "%s", COL_HDR[c]);
+    } else if (sort->n == 1) {
+      snprintf(label, sizeof(label), "%s %c", COL_HDR[c], sort->keys[at].desc ? 'v' : '^');
+    } else {
+      snprintf(label, sizeof(label), "%s %c%d", COL_HDR[c],
+               sort->keys[at].desc ? 'v' : '^', at + 1);
+    }
+
     mu_Font font = ctx->style->font;
-    int tw = ctx->text_width(font, COL_HDR[c], -1);
+    int tw = ctx->text_width(font, label, -1);
     int th = ctx->text_height(font);
     mu_Vec2 pos;
     pos.y = r.y + (r.h - th) / 2;
     pos.x = (c >= 4) ? r.x + r.w - tw - 2 : r.x + 2;  /* numeric cols right-align */
 
     mu_push_clip_rect(ctx, r);
-    mu_draw_text(ctx, font, COL_HDR[c], -1, pos, TH_HEADER_TEXT);
+    mu_draw_text(ctx, font, label, -1, pos,
+                 ctx->hover == id ? TH_TEXT_BRIGHT : TH_HEADER_TEXT);
     mu_pop_clip_rect(ctx);
     tbl_separator(ctx, r, TH_SEPARATOR);
   }
@@ -85,16 +97,17 @@ static void draw_header(mu_Context *ctx) {
 
 /* ---- Position Row ---- */
 
-/* GCC -Wformat-truncation=2 warns that a double *could* produce 300+ bytes.
-   Our values are bounded financial data and snprintf truncates safely.
-   These are display-only cell strings — truncation is harmless. */
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-truncation"
+/* Formatted numeric cells of every position, reused while values hold */
+static CellCache s_cells;
 
-static void draw_row(mu_Context *ctx, const Position *p, int row_idx, int tick) {
-  char buf[64];
+static void draw_row(mu_Context *ctx, const PositionBook *book, int row, int row_idx,
+                     int tick)
+{
+  const Position *p = &book->items[row];
+  CellCache *cc = &s_cells;
   mu_Color bg = (row_idx % 2 == 0) ? TH_ROW_EVEN : TH_ROW_ODD;
   mu_Color txt = p->stale ? TH_STALE : TH_TEXT;
+  const int R = MU_OPT_ALIGNRIGHT;
 
   mu_layout_row(ctx, COL_COUNT, COL_W, ROW_H);
 
@@ -118,103 +131,146 @@ static void draw_row(mu_Context *ctx, const Position *p, int row_idx, int tick)
   tbl_cell(ctx, p->cusip, bg, TH_TEXT_DIM, 0);
 
   /* 2: Book */
-  tbl_cell(ctx, book_short(p->book), bg, TH_TEXT_DIM, 0);
+  tbl_cell(ctx, data_book_short(p->book), bg, TH_TEXT_DIM, 0);
 
   /* 3: Desk */
-  tbl_cell(ctx, desk_short(p->desk), bg, TH_TEXT_DIM, 0);
+  tbl_cell(ctx, data_desk_short(p->desk), bg, TH_TEXT_DIM, 0);
 
   /* 4: Notional */
-  snprintf(buf, sizeof(buf), "%.1f", p->notional);
-  tbl_cell(ctx, buf, bg, (p->notional >= 0) ? TH_TEXT : TH_PNL_NEG, MU_OPT_ALIGNRIGHT);
+  tbl_cell_cached(ctx, cell_notional(cc, row, 4, p->notional, 1, 0), bg,
+                  (p->notional >= 0) ? TH_TEXT : TH_PNL_NEG, R);
 
   /* 5: Avg Price */
-  if (p->avg_price > 0.001)
-    snprintf(buf, sizeof(buf), "%.3f", p->avg_price);
+  if (FX_PRICE_D(p->avg_price) > 0.001)
+    tbl_cell_cached(ctx, cell_price(cc, row, 5, p->avg_price, 3, 0), bg, TH_TEXT, R);
   else
-    snprintf(buf, sizeof(buf), "-");
-  tbl_cell(ctx, buf, bg, TH_TEXT, MU_OPT_ALIGNRIGHT);
+    tbl_cell(ctx, "-", bg, TH_TEXT, R);
 
   /* 6: Mkt Price */
-  if (p->mkt_price > 0.001)
-    snprintf(buf, sizeof(buf), "%.3f", p->mkt_price);
+  if (FX_PRICE_D(p->mkt_price) > 0.001)
+    tbl_cell_cached(ctx, cell_price(cc, row, 6, p->mkt_price, 3, 0), bg,
+                    p->stale ? TH_STALE : TH_TEXT_BRIGHT, R);
   else
-    snprintf(buf, sizeof(buf), "-");
-  tbl_cell(ctx, buf, bg, p->stale ? TH_STALE : TH_TEXT_BRIGHT, MU_OPT_ALIGNRIGHT);
+    tbl_cell(ctx, "-", bg, p->stale ? TH_STALE : TH_TEXT_BRIGHT, R);
 
   /* 7: Total P&L */
-  tbl_cell_pnl(ctx, p->pnl_total, "%+.1f", bg);
+  tbl_cell_cached(ctx, cell_pnl(cc, row, 7, p->pnl_total, 1, FMT_PLUS), bg,
+                  th_pnl_color(FX_PNL_D(p->pnl_total)), R);
 
   /* 8: Day P&L */
-  tbl_cell_pnl(ctx, p->pnl_day, "%+.1f", bg);
+  tbl_cell_cached(ctx, cell_pnl(cc, row, 8, p->pnl_day, 1, FMT_PLUS), bg,
+                  th_pnl_color(FX_PNL_D(p->pnl_day)), R);
 
   /* 9: DV01 */
-  tbl_cell_num(ctx, p->dv01, "%.0f", bg, TH_TEXT);
+  tbl_cell_cached(ctx, cell_f64(cc, row, 9, p->dv01, 0, 0), bg, TH_TEXT, R);
 
   /* 10: CS01 */
-  tbl_cell_num(ctx, p->cs01, "%.0f", bg, (p->cs01 > 0) ? TH_TEXT : TH_TEXT_DIM);
+  tbl_cell_cached(ctx, cell_f64(cc, row, 10, p->cs01, 0, 0), bg,
+                  (p->cs01 > 0) ? TH_TEXT : TH_TEXT_DIM, R);
 
   /* 11: Delta */
-  snprintf(buf, sizeof(buf), "%.2f", p->delta);
-  tbl_cell(ctx, buf, bg, TH_TEXT, MU_OPT_ALIGNRIGHT);
+  tbl_cell_cached(ctx, cell_f64(cc, row, 11, p->delta, 2, 0), bg, TH_TEXT, R);
 
   /* 12: Vega */
-  tbl_cell_num(ctx, p->vega, "%.1f", bg, (p->vega > 0.01) ? TH_TEXT : TH_TEXT_DIM);
+  tbl_cell_cached(ctx, cell_f64(cc, row, 12, p->vega, 1, 0), bg,
+                  (p->vega > 0.01) ? TH_TEXT : TH_TEXT_DIM, R);
 
   /* 13: Theta */
-  tbl_cell_pnl(ctx, p->theta, "%.2f", bg);
+  tbl_cell_cached(ctx, cell_f64(cc, row, 13, p->theta, 2, 0), bg, th_pnl_color(p->theta), R);
 
   /* 14: Gamma */
-  snprintf(buf, sizeof(buf), "%.3f", p->gamma);
-  tbl_cell(ctx, buf, bg, TH_TEXT_DIM, MU_OPT_ALIGNRIGHT);
+  tbl_cell_cached(ctx, cell_f64(cc, row, 14, p->gamma, 3, 0), bg, TH_TEXT_DIM, R);
 }
 
-#pragma GCC diagnostic pop
 
+/* ---- Totals Cells (notional .. gamma) ---- */
 
-/* ---- Book Group Header ---- */
+static void draw_totals_cells(mu_Context *ctx, const ViewTotals *t, mu_Color bg) {
+  char buf[64];
 
-static void draw_group_header(mu_Context *ctx, const char *book, const char *desk) {
-  mu_layout_row(ctx, 1, (int[]){ -1 }, ROW_H);
+  /* Notional */
+  fmt_notional(buf, (int)sizeof(buf), t->notional, 1, 0);
+  tbl_cell(ctx, buf, bg, th_pnl_color(FX_NOTIONAL_D(t->notional)), MU_OPT_ALIGNRIGHT);
+
+  /* Avg/Mkt — not meaningful */
+  tbl_cell_empty(ctx, bg);
+  tbl_cell_empty(ctx, bg);
+
+  /* P&L totals */
+  tbl_cell_fxpnl(ctx, t->pnl, 1, FMT_PLUS, bg);
+  tbl_cell_fxpnl(ctx, t->pnl_day, 1, FMT_PLUS, bg);
+
+  /* Risk totals */
+  tbl_cell_num(ctx, t->dv01, 0, 0, bg, TH_TEXT_BRIGHT);
+  tbl_cell_num(ctx, t->cs01, 0, 0, bg, TH_TEXT);
+
+  /* Delta — skip aggregate */
+  tbl_cell_empty(ctx, bg);
+
+  tbl_cell_num(ctx, t->vega, 1, 0, bg, TH_TEXT);
+  tbl_cell_pnl(ctx, t->theta, 2, 0, bg);
+
+  /* Gamma — skip aggregate */
+  tbl_cell_empty(ctx, bg);
+}
+
+
+/* ---- Group Header (label over the text columns, then live subtotals) ---- */
+
+/* Labels are bounded by the interned names; truncation is harmless. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+
+/* Returns 1 when clicked (toggle collapse) */
+static int draw_group_header(mu_Context *ctx, uint32_t key, const char *label,
+                             int folded, int rule, const ViewTotals *t)
+{
+  mu_layout_row(ctx, COL_COUNT, COL_W, ROW_H);
   mu_Rect r = mu_layout_next(ctx);
-  mu_draw_rect(ctx, r, TH_GROUP_BG);
+  for (int c = 1; c < 4; c++) {
+    mu_Rect n = mu_layout_next(ctx);
+    r.w = n.x + n.w - r.x;
+  }
 
-  char hdr[64];
-  snprintf(hdr, sizeof(hdr), ">> %s / %s", book, desk);
+  char id_buf[24];
+  snprintf(id_buf, sizeof(id_buf), "!grp_%u", (unsigned)key);
+  mu_Id id = mu_get_id(ctx, id_buf, (int)strlen(id_buf));
+  mu_update_control(ctx, id, r, 0);
+  int clicked = ctx->mouse_pressed == MU_MOUSE_LEFT && ctx->focus == id;
+
+  mu_draw_rect(ctx, r, TH_GROUP_BG);
+  char hdr[96];
+  snprintf(hdr, sizeof(hdr), "%c %s (%d)", folded ? '+' : '-', label, t->count);
   mu_push_clip_rect(ctx, r);
   mu_draw_text(ctx, ctx->style->font, hdr, -1,
                mu_vec2(r.x + 4, r.y + (r.h - ctx->text_height(ctx->style->font))/2),
-               TH_HEADER_TEXT);
+               ctx->hover == id ? TH_TEXT_BRIGHT : TH_HEADER_TEXT);
   mu_pop_clip_rect(ctx);
-}
+  tbl_separator(ctx, r, TH_SEPARATOR);
 
+  draw_totals_cells(ctx, t, TH_GROUP_BG);
 
-/* ---- Summary / Totals ---- */
+  /* Rule between groups, inside the header so every grid line is ROW_H */
+  if (rule) {
+    mu_Rect body = mu_get_current_container(ctx)->body;
+    mu_draw_rect(ctx, mu_rect(body.x, r.y, body.w, 2), TH_SEPARATOR);
+  }
+  return clicked;
+}
+
+#pragma GCC diagnostic pop
 
-static void draw_summary(mu_Context *ctx, PositionBook *book, ScreenFilter *flt) {
-  double tot_notl = 0, tot_pnl = 0, tot_dpnl = 0;
-  double tot_dv01 = 0, tot_cs01 = 0, tot_vega = 0, tot_theta = 0;
-  int count = 0;
 
-  for (int i = 0; i < book->count; i++) {
-    if (!screen_filter_check(flt, &book->items[i])) continue;
-    const Position *p = &book->items[i];
-    tot_notl  += p->notional;
-    tot_pnl   += p->pnl_total;
-    tot_dpnl  += p->pnl_day;
-    tot_dv01  += p->dv01;
-    tot_cs01  += p->cs01;
-    tot_vega  += p->vega;
-    tot_theta += p->theta;
-    count++;
-  }
+/* ---- Summary / Totals ---- */
 
+static void draw_summary(mu_Context *ctx, const ViewTotals *t) {
   mu_Color bg = TH_SUMMARY_BG;
   char buf[64];
 
   mu_layout_row(ctx, COL_COUNT, COL_W, ROW_H + 2);
 
   /* TOTAL label */
-  snprintf(buf, sizeof(buf), "TOTAL (%d)", count);
+  snprintf(buf, sizeof(buf), "TOTAL (%d)", t->count);
   tbl_cell(ctx, buf, bg, TH_HEADER_TEXT, 0);
 
   /* CUSIP, Book, Desk — empty */
@@ -222,109 +278,653 @@ static void draw_summary(mu_Context *ctx, PositionBook *book, ScreenFilter *flt)
   tbl_cell_empty(ctx, bg);
   tbl_cell_empty(ctx, bg);
 
-  /* Notional */
-  tbl_cell_pnl(ctx, tot_notl, "%.1f", bg);
-
-  /* Avg/Mkt — not meaningful */
-  tbl_cell_empty(ctx, bg);
-  tbl_cell_empty(ctx, bg);
-
-  /* P&L totals */
-  tbl_cell_pnl(ctx, tot_pnl, "%+.1f", bg);
-  tbl_cell_pnl(ctx, tot_dpnl, "%+.1f", bg);
-
-  /* Risk totals */
-  tbl_cell_num(ctx, tot_dv01, "%.0f", bg, TH_TEXT_BRIGHT);
-  tbl_cell_num(ctx, tot_cs01, "%.0f", bg, TH_TEXT);
-
-  /* Delta — skip aggregate */
-  tbl_cell_empty(ctx, bg);
-
-  tbl_cell_num(ctx, tot_vega, "%.1f", bg, TH_TEXT);
-  tbl_cell_pnl(ctx, tot_theta, "%.2f", bg);
-
-  /* Gamma — skip aggregate */
-  tbl_cell_empty(ctx, bg);
+  draw_totals_cells(ctx, t, bg);
 }
 
 
 /* ---- Status Bar ---- */
 
-static void draw_status(mu_Context *ctx, int n_positions) {
+/* Same bounded-values argument as draw_row: truncation is harmless here. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+
+static void draw_status(mu_Context *ctx, const PositionBook *book) {
   mu_layout_row(ctx, 1, (int[]){ -1 }, 16);
   mu_Rect r = mu_layout_next(ctx);
   mu_draw_rect(ctx, r, TH_STATUS_BG);
 
-  char buf[128];
-  snprintf(buf, sizeof(buf), " bbg_tui v0.1 | Positions: %d | engine: microui %s",
-           n_positions, MU_VERSION);
+  const BookTotals *t = &book->totals;
+  char buf[192];
+  snprintf(buf, sizeof(buf),
+           " bbg_tui v0.1 | Positions: %d (%d open) | Book P&L %+.1fK"
+           " | Real %+.1fK  Unreal %+.1fK  Carry %+.1fK | engine: microui %s",
+           book->count, t->n_open, FX_PNL_D(t->pnl_total),
+           FX_PNL_D(t->pnl_realized), FX_PNL_D(t->pnl_unrealized),
+           FX_PNL_D(t->pnl_carry),
+           MU_VERSION);
   mu_push_clip_rect(ctx, r);
   mu_draw_text(ctx, ctx->style->font, buf, -1, mu_vec2(r.x + 2, r.y + 1), TH_TEXT_DIM);
   mu_pop_clip_rect(ctx);
 }
 
+#pragma GCC diagnostic pop
+
+
+/* ---- Group-By Picker ---- */
+
+static const GroupSpec GROUP_PRESETS[] = {
+  { { GROUP_BOOK, GROUP_DESK }, 2 },
+  { { GROUP_BOOK },             1 },
+  { { GROUP_DESK },             1 },
+  { { GROUP_ASSET },            1 },
+  { { GROUP_CCY },              1 },
+  { { GROUP_CCY, GROUP_ASSET }, 2 },
+  { { 0 },                      0 },
+};
+#define GROUP_PRESET_COUNT (int)(sizeof(GROUP_PRESETS) / sizeof(GROUP_PRESETS[0]))
+
+/* Button cycling a grouping through GROUP_PRESETS ("Group: Book+Desk") */
+static void draw_group_button(mu_Context *ctx, const char *prefix, GroupSpec *spec) {
+  char label[48];
+  snprintf(label, sizeof(label), "%s", prefix);                 /* <= 8 chars */
+  if (!spec->n) strcat(label, "none");
+  for (int i = 0; i < spec->n; i++) {
+    if (i) strcat(label, "+");
+    strcat(label, group_dim_name((GroupDim)spec->dims[i]));    /* <= 3 x 5 chars */
+  }
+  if (!mu_button_ex(ctx, label, 0, 0)) return;
+
+  int at = 0;
+  while (at < GROUP_PRESET_COUNT && !group_spec_eq(&GROUP_PRESETS[at], spec)) at++;
+  *spec = GROUP_PRESETS[(at + 1) % GROUP_PRESET_COUNT];
+}
+
+
+/* ============================================================================
+**  Instrument Lookup (filter-box completion)
+** ============================================================================*/
+
+#define LOOKUP_KEYS   (MAX_POSITIONS * 2)           /* name + cusip per row */
+#define LOOKUP_ROWS   8
+#define LOOKUP_ROW_H  18
+#define LOOKUP_W      300
+
+enum { LK_KIND_NAME, LK_KIND_CUSIP };
+
+static char     s_lk_text[LOOKUP_KEYS * 64 + SM_PAD];
+static LkKey    s_lk_keys[LOOKUP_KEYS];
+static LkWord   s_lk_words[LOOKUP_KEYS * 12];
+static Lookup   s_lookup;
+static const PositionBook *s_lk_book;
+static int      s_lk_count = -1;
+static int      s_lk_open;                  /* dropdown drawn last frame */
+
+/* Re-index when rows were added (names never change once added) */
+static void lookup_sync(const PositionBook *book) {
+  if (s_lk_book == book && s_lk_count == book->count) return;
+  if (!s_lk_book) {
+    lk_init(&s_lookup, s_lk_text, (int)sizeof(s_lk_text), s_lk_keys, LOOKUP_KEYS,
+            s_lk_words, (int)(sizeof(s_lk_words) / sizeof(s_lk_words[0])));
+  }
+  lk_reset(&s_lookup);
+  for (int i = 0; i < book->count; i++) {
+    lk_add(&s_lookup, book->items[i].instrument, i, LK_KIND_NAME);
+    lk_add(&s_lookup, book->items[i].cusip,      i, LK_KIND_CUSIP);
+  }
+  lk_finish(&s_lookup);
+  s_lk_book  = book;
+  s_lk_count = book->count;
+}
+
+
+/* Jump to a completion: filter on the text that matched (name or CUSIP) */
+static void lookup_pick(mu_Context *ctx, Screen *scr, const PositionBook *book,
+                        const LkHit *h)
+{
+  const Position *p = &book->items[h->id];
+  int cusip = s_lookup.keys[h->key].kind == LK_KIND_CUSIP;
+  snprintf(scr->filter.search, sizeof(scr->filter.search), "%s",
+           cusip ? p->cusip : p->instrument);
+  screen_filter_touch(scr);
+  scr->selected_row = h->id;
+  mu_set_focus(ctx, 0);
+}
+
+
+/* Completion dropdown under the filter textbox (tb_id / tb). Shown while
+   the box has focus and holds plain text; Enter takes the top match. */
+static void draw_lookup(mu_Context *ctx, Screen *scr, const PositionBook *book,
+                        mu_Id tb_id, mu_Rect tb, int submitted)
+{
+  const char   *q  = scr->filter.search;
+  mu_Container *dd = mu_get_container(ctx, "!lookup");
+  mu_Rect       dr = dd->rect;
+  int over = s_lk_open &&
+             ctx->mouse_pos.x >= dr.x && ctx->mouse_pos.x < dr.x + dr.w &&
+             ctx->mouse_pos.y >= dr.y && ctx->mouse_pos.y < dr.y + dr.h;
+
+  LkHit hits[LOOKUP_ROWS];
+  int   n = 0;
+  if (q[0] && !qry_is_query(q) && (ctx->focus == tb_id || submitted || over)) {
+    lookup_sync(book);
+    n = lk_query(&s_lookup, q, hits, LOOKUP_ROWS);
+  }
+  if (submitted && n > 0) {
+    lookup_pick(ctx, scr, book, &hits[0]);
+    n = 0;
+  }
+  s_lk_open = n > 0;
+  if (!s_lk_open) return;
+
+  int pad = ctx->style->padding;
+  dd->rect = mu_rect(tb.x, tb.y + tb.h, LOOKUP_W,
+                     n * (LOOKUP_ROW_H + ctx->style->spacing) + 2 * pad);
+  dd->open = 1;
+  mu_bring_to_front(ctx, dd);
+
+  if (mu_begin_window_ex(ctx, "!lookup", dd->rect,
+                         MU_OPT_NOTITLE | MU_OPT_NORESIZE | MU_OPT_NOSCROLL))
+  {
+    mu_layout_row(ctx, 1, (int[]){ -1 }, LOOKUP_ROW_H);
+    for (int i = 0; i < n; i++) {
+      const Position *p = &book->items[hits[i].id];
+      char label[96];
+      snprintf(label, sizeof(label), "%-22s %s", p->instrument, p->cusip);
+      if (mu_button_ex(ctx, label, 0, 0)) {
+        lookup_pick(ctx, scr, book, &hits[i]);
+        s_lk_open = 0;
+      }
+    }
+    mu_end_window(ctx);
+  }
+}
+
 
 /* ============================================================================
 **  Main Render Entry Point
 ** ============================================================================*/
 
+/* ---- Grouped grid, one entry per ROW_H line: header (k < 0) or row k ---- */
+typedef struct { int group, k; } GridLine;
+static GridLine s_lines[MAX_POSITIONS + GROUP_MAX];
+
 void poms_render(mu_Context *ctx, Screen *scr, PositionBook *book, int tick) {
   ScreenFilter *flt = &scr->filter;
 
   /* ---- Filter Controls ---- */
-  mu_layout_row(ctx, 7, (int[]){ 50, 120, 55, 55, 55, 55, -1 }, 22);
+  int res = 0;
+  mu_layout_row(ctx, 8, (int[]){ 50, 120, 55, 55, 55, 55, 120, -1 }, 22);
   mu_label(ctx, "Filter:");
-  mu_textbox(ctx, flt->search, sizeof(flt->search));
-  mu_checkbox(ctx, "Bond", &flt->show_bonds);
-  mu_checkbox(ctx, "Swap", &flt->show_swaps);
-  mu_checkbox(ctx, "Fut",  &flt->show_futures);
-  mu_checkbox(ctx, "Vol",  &flt->show_swaptions);
-  mu_layout_next(ctx); /* spacer */
+  char   *search = flt->search;                  /* id as mu_textbox() makes it */
+  mu_Id   search_id = mu_get_id(ctx, &search, sizeof(search));
+  mu_Rect search_r  = mu_layout_next(ctx);
+  int     search_res = mu_textbox_raw(ctx, flt->search, sizeof(flt->search),
+                                      search_id, search_r, 0);
+  res |= search_res;
+  res |= mu_checkbox(ctx, "Bond", &flt->show_bonds);
+  res |= mu_checkbox(ctx, "Swap", &flt->show_swaps);
+  res |= mu_checkbox(ctx, "Fut",  &flt->show_futures);
+  res |= mu_checkbox(ctx, "Vol",  &flt->show_swaptions);
+  if (res & MU_RES_CHANGE) screen_filter_touch(scr);
+  draw_group_button(ctx, "Group: ", &scr->group);
+
+  /* Ranked completions as the user types */
+  draw_lookup(ctx, scr, book, search_id, search_r, search_res & MU_RES_SUBMIT);
+
+  /* Cached rows of the screen's view (shared with any screen on the same
+     filter) — only recomputed after a filter edit or new positions */
+  const ScreenView  *v = screen_view(scr, book);
+  const ScreenMatch *m = &v->match;
+
+  /* Filter state: query error, or "filtering..." while a rebuild is in
+     flight (the grid keeps the previous result until it lands) */
+  {
+    mu_Rect r = mu_layout_next(ctx);
+    mu_Font font = ctx->style->font;
+    mu_Vec2 at = mu_vec2(r.x + 4, r.y + (r.h - ctx->text_height(font)) / 2);
+    if (v->req.pending) {
+      mu_draw_text(ctx, font, "filtering...", -1, at, TH_TEXT_DIM);
+    } else if (m->err[0]) {
+      mu_draw_text(ctx, font, m->err, -1, at, TH_PNL_NEG);
+    } else if (v->name[0] || v->refs > 1) {
+      char note[64];
+      snprintf(note, sizeof(note), "view %s%s(%d screen%s)", v->name,
+               v->name[0] ? " " : "", v->refs, v->refs == 1 ? "" : "s");
+      mu_draw_text(ctx, font, note, -1, at, TH_TEXT_DIM);
+    }
+  }
 
   /* ---- Separator ---- */
   mu_layout_row(ctx, 1, (int[]){ -1 }, 1);
   mu_draw_rect(ctx, mu_layout_next(ctx), TH_SEPARATOR);
 
-  /* ---- Column Headers ---- */
-  draw_header(ctx);
+  /* ---- Column Headers (click to sort) ---- */
+  draw_header(ctx, &scr->sort);
+  const ScreenOrder *o = screen_order(scr, book);
 
   mu_layout_row(ctx, 1, (int[]){ -1 }, 1);
   mu_draw_rect(ctx, mu_layout_next(ctx), TH_SEPARATOR);
 
   /* ---- Scrollable Grid ---- */
   mu_layout_row(ctx, 1, (int[]){ -1 }, -42);
-  mu_begin_panel(ctx, "grid");
-  {
-    int row_idx = 0;
-    const char *last_book = NULL;
-
-    for (int i = 0; i < book->count; i++) {
-      Position *p = &book->items[i];
-      if (!screen_filter_check(flt, p)) continue;
-
-      /* Book group separator */
-      if (!last_book || strcmp(last_book, p->book) != 0) {
-        if (last_book) {
-          mu_layout_row(ctx, 1, (int[]){ -1 }, 2);
-          mu_draw_rect(ctx, mu_layout_next(ctx), TH_SEPARATOR);
-        }
-        draw_group_header(ctx, p->book, p->desk);
-        last_book = p->book;
-      }
+  /* Virtualized: only lines inside the viewport are laid out and drawn */
+  cell_cache_sync(&s_cells, book, ctx->style->font);
+  bbg_Table t;
+  if (scr->group.n == 0) {
+    bbg_table_begin(ctx, &t, "grid", o->count, ROW_H);
+    for (int k = t.first; k < t.last; k++) {
+      draw_row(ctx, book, o->rows[k], k, tick);
+    }
+  } else {
+    /* Hash-grouped on the screen's dims, in order of each group's first
+       sorted row; headers carry live subtotals (computed as drawn) and
+       toggle collapse on click. A collapsed group is just its header.
+       Flattened to one line per header / row so the table can skip to
+       the viewport; only visible headers compute their subtotals. */
+    const ScreenGroups *g = screen_groups(scr, book);
+    int n = 0;
+    for (int gi = 0; gi < g->set.ngroups; gi++) {
+      const Group *grp = &g->set.groups[gi];
+      s_lines[n++] = (GridLine){ gi, -1 };
+      if (group_folded(&scr->folds, &scr->group, grp->key)) continue;
+      for (int k = 0; k < grp->count; k++) s_lines[n++] = (GridLine){ gi, k };
+    }
 
-      draw_row(ctx, p, row_idx, tick);
-      row_idx++;
+    bbg_table_begin(ctx, &t, "grid", n, ROW_H);
+    for (int i = t.first; i < t.last; i++) {
+      const Group *grp = &g->set.groups[s_lines[i].group];
+      int k = s_lines[i].k;
+      if (k >= 0) {
+        draw_row(ctx, book, g->set.rows[grp->first + k], k, tick);
+        continue;
+      }
+      char label[80];
+      group_label(&scr->group, book, grp->key, label, (int)sizeof(label));
+      int folded = group_folded(&scr->folds, &scr->group, grp->key);
+      if (draw_group_header(ctx, grp->key, label, folded, i > 0,
+                            screen_group_totals(scr, book, s_lines[i].group))) {
+        group_fold_set(&scr->folds, &scr->group, grp->key, !folded);
+      }
     }
   }
-  mu_end_panel(ctx);
+  bbg_table_end(ctx, &t);
 
   /* ---- Amber accent line above totals ---- */
   mu_layout_row(ctx, 1, (int[]){ -1 }, 1);
   mu_draw_rect(ctx, mu_layout_next(ctx), TH_HEADER_TEXT);
 
   /* ---- Summary ---- */
-  draw_summary(ctx, book, flt);
+  draw_summary(ctx, screen_totals(scr, book));
 
   /* ---- Status ---- */
-  draw_status(ctx, book->count);
+  draw_status(ctx, book);
+}
+
+
+/* ============================================================================
+**  Movers Screen
+** ============================================================================*/
+
+#define MOVERS_COLS 4
+
+static const int MOVERS_W[MOVERS_COLS] = { 24, 150, 48, 70 };
+
+static void draw_movers_panel(mu_Context *ctx, Movers *m, const PositionBook *book,
+                              MoversKind k)
+{
+  int rows[MOVERS_N];
+  int n = movers_top(m, book, k, rows, MOVERS_N);
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, ROW_H);
+  tbl_cell(ctx, movers_label(k), TH_GROUP_BG, TH_HEADER_TEXT, 0);
+
+  mu_layout_row(ctx, MOVERS_COLS, MOVERS_W, ROW_H);
+  tbl_cell(ctx, "#",          TH_HEADER_BG, TH_HEADER_TEXT, 0);
+  tbl_cell(ctx, "INSTRUMENT", TH_HEADER_BG, TH_HEADER_TEXT, 0);
+  tbl_cell(ctx, "BOOK",       TH_HEADER_BG, TH_HEADER_TEXT, 0);
+  tbl_cell(ctx, k == MOVERS_DV01 ? "DV01" : "DAY P&L",
+           TH_HEADER_BG, TH_HEADER_TEXT, MU_OPT_ALIGNRIGHT);
+
+  for (int i = 0; i < n; i++) {
+    const Position *p = &book->items[rows[i]];
+    mu_Color bg = (i % 2 == 0) ? TH_ROW_EVEN : TH_ROW_ODD;
+    char rank[12];
+    fmt_scaled(rank, (int)sizeof(rank), i + 1, 0, 0, 0);
+
+    mu_layout_row(ctx, MOVERS_COLS, MOVERS_W, ROW_H);
+    tbl_cell(ctx, rank, bg, TH_TEXT_DIM, 0);
+    tbl_cell(ctx, p->instrument, bg, p->stale ? TH_STALE : TH_TEXT, 0);
+    tbl_cell(ctx, data_book_short(p->book), bg, TH_TEXT_DIM, 0);
+    if (k == MOVERS_DV01) tbl_cell_num(ctx, p->dv01, 0, 0, bg, TH_TEXT_BRIGHT);
+    else                  tbl_cell_fxpnl(ctx, p->pnl_day, 1, FMT_PLUS, bg);
+  }
+}
+
+
+void poms_render_movers(mu_Context *ctx, Movers *m, const PositionBook *book) {
+  unsigned rebuilds = 0;
+  for (int k = 0; k < MOVERS_COUNT; k++) rebuilds += m->top[k].rebuilds;
+
+  char note[96];
+  snprintf(note, sizeof(note), "Top %d per metric, updated per position tick (%u rescans)",
+           MOVERS_N, rebuilds);
+  mu_layout_row(ctx, 1, (int[]){ -1 }, 22);
+  mu_label(ctx, note);
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, 1);
+  mu_draw_rect(ctx, mu_layout_next(ctx), TH_SEPARATOR);
+
+  /* One panel per metric, splitting the width */
+  int avail = mu_get_current_container(ctx)->body.w - 2 * ctx->style->padding;
+  int w     = (avail - (MOVERS_COUNT - 1) * ctx->style->spacing) / MOVERS_COUNT;
+  mu_layout_row(ctx, MOVERS_COUNT, (int[]){ w, w, w }, -20);
+  for (int k = 0; k < MOVERS_COUNT; k++) {
+    char id[16];
+    snprintf(id, sizeof(id), "movers_%d", k);
+    mu_begin_panel(ctx, id);
+    draw_movers_panel(ctx, m, book, (MoversKind)k);
+    mu_end_panel(ctx);
+  }
+
+  draw_status(ctx, book);
+}
+
+
+/* ============================================================================
+**  Pivot Screen
+** ============================================================================*/
+
+#define PIVOT_HEAD_W   150
+#define PIVOT_CELL_W   80
+#define PIVOT_MAX_COLS (MU_MAX_WIDTHS - 2)          /* + row label + total */
+
+/* Cell decimals and fmt flags per measure */
+static const int PIVOT_DEC[PIVOT_MEASURE_COUNT]   = { 0, 1, 1, 1 };
+static const int PIVOT_FLAGS[PIVOT_MEASURE_COUNT] = { 0, 0, FMT_PLUS, 0 };
+
+static char s_pv_rlabel[MAX_POSITIONS][64];
+static char s_pv_clabel[MAX_POSITIONS][64];
+
+/* Label every group key ("All" when ungrouped), then order them by label */
+static void label_keys(const uint32_t *keys, int n, const GroupSpec *spec,
+                       const PositionBook *book, char (*label)[64], int *order)
+{
+  for (int i = 0; i < n; i++) {
+    if (spec->n) group_label(spec, book, keys[i], label[i], 64);
+    else         snprintf(label[i], 64, "All");
+    int at = i;
+    while (at > 0 && strcmp(label[order[at - 1]], label[i]) > 0) {
+      order[at] = order[at - 1];
+      at--;
+    }
+    order[at] = i;
+  }
+}
+
+static void pivot_cell_value(mu_Context *ctx, PivotMeasure m, double v, mu_Color bg,
+                             mu_Color fg)
+{
+  if (m == PIVOT_PNL_DAY) tbl_cell_pnl(ctx, v, PIVOT_DEC[m], PIVOT_FLAGS[m], bg);
+  else                    tbl_cell_num(ctx, v, PIVOT_DEC[m], PIVOT_FLAGS[m], bg, fg);
+}
+
+
+void poms_render_pivot(mu_Context *ctx, Screen *scr, const PositionBook *book) {
+  const Pivot *pv = book_pivot_sync(&scr->pivot, &scr->pivot_def, book);
+  PivotMeasure m  = scr->pivot_measure;
+
+  /* ---- Axis / measure pickers ---- */
+  mu_layout_row(ctx, 4, (int[]){ 150, 150, 110, -1 }, 22);
+  draw_group_button(ctx, "Rows: ", &scr->pivot_def.rows_by);
+  draw_group_button(ctx, "Cols: ", &scr->pivot_def.cols_by);
+  char mlabel[32];
+  snprintf(mlabel, sizeof(mlabel), "Measure: %s", pivot_measure_name(m));
+  if (mu_button_ex(ctx, mlabel, 0, 0)) {
+    scr->pivot_measure = (PivotMeasure)((m + 1) % PIVOT_MEASURE_COUNT);
+  }
+  char note[96];
+  int  ncols = pv->ncols < PIVOT_MAX_COLS ? pv->ncols : PIVOT_MAX_COLS;
+  snprintf(note, sizeof(note), "%d x %d, %d cells, %d positions%s",
+           pv->nrows, pv->ncols, pv->ncells, pv->total.count,
+           ncols < pv->ncols ? " (columns clipped)" : "");
+  mu_label(ctx, note);
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, 1);
+  mu_draw_rect(ctx, mu_layout_next(ctx), TH_SEPARATOR);
+
+  int rorder[MAX_POSITIONS], corder[MAX_POSITIONS];
+  uint32_t keys[MAX_POSITIONS];
+  for (int i = 0; i < pv->nrows; i++) keys[i] = pv->rows[i].key;
+  label_keys(keys, pv->nrows, &scr->pivot.def.rows_by, book, s_pv_rlabel, rorder);
+  for (int i = 0; i < pv->ncols; i++) keys[i] = pv->cols[i].key;
+  label_keys(keys, pv->ncols, &scr->pivot.def.cols_by, book, s_pv_clabel, corder);
+
+  int widths[MU_MAX_WIDTHS];
+  widths[0] = PIVOT_HEAD_W;
+  for (int c = 0; c <= ncols; c++) widths[c + 1] = PIVOT_CELL_W;
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, -20);
+  mu_begin_panel(ctx, "pivot");
+
+  /* ---- Column heads ---- */
+  mu_layout_row(ctx, ncols + 2, widths, ROW_H);
+  tbl_cell(ctx, pivot_measure_name(m), TH_HEADER_BG, TH_HEADER_TEXT, 0);
+  for (int c = 0; c < ncols; c++) {
+    tbl_cell(ctx, s_pv_clabel[corder[c]], TH_HEADER_BG, TH_HEADER_TEXT, MU_OPT_ALIGNRIGHT);
+  }
+  tbl_cell(ctx, "TOTAL", TH_HEADER_BG, TH_HEADER_TEXT, MU_OPT_ALIGNRIGHT);
+
+  /* ---- One line per row head: cells, then the row total ---- */
+  for (int i = 0; i < pv->nrows; i++) {
+    const PivotHead *rh = &pv->rows[rorder[i]];
+    mu_Color bg = (i % 2 == 0) ? TH_ROW_EVEN : TH_ROW_ODD;
+    mu_layout_row(ctx, ncols + 2, widths, ROW_H);
+    tbl_cell(ctx, s_pv_rlabel[rorder[i]], bg, TH_TEXT, 0);
+    for (int c = 0; c < ncols; c++) {
+      const PivotCell *cell = pivot_cell(pv, rh->key, pv->cols[corder[c]].key);
+      if (cell) pivot_cell_value(ctx, m, cell->sum[m], bg, TH_TEXT);
+      else      tbl_cell_empty(ctx, bg);
+    }
+    pivot_cell_value(ctx, m, rh->sum[m], TH_GROUP_BG, TH_TEXT_BRIGHT);
+  }
+
+  /* ---- Column totals and the grand total ---- */
+  mu_layout_row(ctx, ncols + 2, widths, ROW_H + 2);
+  tbl_cell(ctx, "TOTAL", TH_SUMMARY_BG, TH_HEADER_TEXT, 0);
+  for (int c = 0; c < ncols; c++) {
+    pivot_cell_value(ctx, m, pv->cols[corder[c]].sum[m], TH_SUMMARY_BG, TH_TEXT_BRIGHT);
+  }
+  pivot_cell_value(ctx, m, pv->total.sum[m], TH_SUMMARY_BG, TH_TEXT_BRIGHT);
+
+  mu_end_panel(ctx);
+
+  draw_status(ctx, book);
+}
+
+
+/* ============================================================================
+**  DV01 Ladder Screen
+** ============================================================================*/
+
+#define LADDER_HEAD_W  140
+#define LADDER_CELL_W  52
+#define LADDER_TOTAL_W 64
+
+static void ladder_line(mu_Context *ctx, const char *label, const LadderVec *v,
+                        mu_Color bg, mu_Color fg)
+{
+  tbl_cell(ctx, label, bg, fg, 0);
+  for (int b = 0; b < LADDER_BUCKETS; b++) {
+    double x = v->b[b];
+    if (x > -0.5 && x < 0.5) tbl_cell_empty(ctx, bg);       /* untouched bucket */
+    else                     tbl_cell_num(ctx, x, 0, 0, bg, fg);
+  }
+  tbl_cell_num(ctx, ladder_total(v), 0, 0, bg, TH_TEXT_BRIGHT);
+}
+
+
+void poms_render_ladder(mu_Context *ctx, Screen *scr, const PositionBook *book) {
+  const ScreenMatch *m = screen_match(scr, book);
+  LadderSet *ls = &scr->ladder;
+  ladder_sync(ls, &scr->group, m->sel, book);
+
+  /* ---- Grouping picker ---- */
+  mu_layout_row(ctx, 2, (int[]){ 150, -1 }, 22);
+  draw_group_button(ctx, "Group: ", &scr->group);
+  char note[96];
+  snprintf(note, sizeof(note), "%d positions, %d ladders, updated per position tick (%u rebuilds)",
+           m->count, ls->count, ls->rebuilds);
+  mu_label(ctx, note);
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, 1);
+  mu_draw_rect(ctx, mu_layout_next(ctx), TH_SEPARATOR);
+
+  int order[GROUP_MAX];
+  label_keys(ls->keys, ls->count, &ls->by, book, s_pv_rlabel, order);
+
+  int widths[LADDER_BUCKETS + 2];
+  widths[0] = LADDER_HEAD_W;
+  for (int b = 0; b < LADDER_BUCKETS; b++) widths[b + 1] = LADDER_CELL_W;
+  widths[LADDER_BUCKETS + 1] = LADDER_TOTAL_W;
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, -20);
+  mu_begin_panel(ctx, "ladder");
+
+  /* ---- Bucket heads ---- */
+  mu_layout_row(ctx, LADDER_BUCKETS + 2, widths, ROW_H);
+  tbl_cell(ctx, "DV01", TH_HEADER_BG, TH_HEADER_TEXT, 0);
+  for (int b = 0; b < LADDER_BUCKETS; b++) {
+    tbl_cell(ctx, LADDER_LABELS[b], TH_HEADER_BG, TH_HEADER_TEXT, MU_OPT_ALIGNRIGHT);
+  }
+  tbl_cell(ctx, "TOTAL", TH_HEADER_BG, TH_HEADER_TEXT, MU_OPT_ALIGNRIGHT);
+
+  /* ---- One ladder per group, then the screen's ---- */
+  for (int i = 0; i < ls->count; i++) {
+    mu_layout_row(ctx, LADDER_BUCKETS + 2, widths, ROW_H);
+    ladder_line(ctx, s_pv_rlabel[order[i]], &ls->ladders[order[i]],
+                (i % 2 == 0) ? TH_ROW_EVEN : TH_ROW_ODD, TH_TEXT);
+  }
+  mu_layout_row(ctx, LADDER_BUCKETS + 2, widths, ROW_H + 2);
+  ladder_line(ctx, scr->name, &ls->total, TH_SUMMARY_BG, TH_HEADER_TEXT);
+
+  mu_end_panel(ctx);
+
+  draw_status(ctx, book);
+}
+
+
+/* ============================================================================
+**  Swaption Vega Screen
+** ============================================================================*/
+
+#define VEGA_HEAD_W 90
+#define VEGA_CELL_W 72
+
+typedef struct {
+  VegaLevel level;
+  uint32_t  key;
+} VegaPick;
+
+/* All, each currency, each currency + desk slice — the picker's cycle */
+static int vega_picks(const VegaCube *vc, const PositionBook *book, VegaPick *out) {
+  int n = 0;
+  out[n++] = (VegaPick){ VEGA_ALL, 0 };
+  for (int c = 0; c < book->ccys.count; c++) {
+    for (int i = 0; i < vc->count; i++) {
+      if ((vc->keys[i] & 0xFFu) == (uint32_t)c) {
+        out[n++] = (VegaPick){ VEGA_CCY, (uint32_t)c };
+        break;
+      }
+    }
+  }
+  for (int i = 0; i < vc->count; i++) out[n++] = (VegaPick){ VEGA_SLICE, vc->keys[i] };
+  return n;
+}
+
+static void vega_pick_label(VegaPick pk, const PositionBook *book, char *buf, int cap) {
+  static const GroupSpec by = { { GROUP_CCY, GROUP_DESK }, 2 };
+  int len = snprintf(buf, (size_t)cap, "Slice: ");
+  if (pk.level == VEGA_ALL)      snprintf(buf + len, (size_t)(cap - len), "All");
+  else if (pk.level == VEGA_CCY) snprintf(buf + len, (size_t)(cap - len), "%s", book->ccys.names[pk.key]);
+  else                           group_label(&by, book, pk.key, buf + len, cap - len);
+}
+
+static void vega_cell(mu_Context *ctx, double v, double scale, mu_Color fg) {
+  mu_Color bg = th_heat(v, scale);
+  if (v > -0.05 && v < 0.05) tbl_cell_empty(ctx, bg);
+  else                       tbl_cell_num(ctx, v, 1, 0, bg, fg);
+}
+
+
+void poms_render_vega(mu_Context *ctx, Screen *scr, const VegaCube *vc,
+                      const PositionBook *book)
+{
+  static VegaPick picks[1 + 2 * GROUP_MAX];
+  int npicks = vega_picks(vc, book, picks);
+  int at = 0;
+  while (at < npicks && (picks[at].level != scr->vega_level || picks[at].key != scr->vega_key)) at++;
+  if (at == npicks) at = 0;                 /* slice gone: back to All */
+
+  /* ---- Slice picker ---- */
+  char label[96];
+  vega_pick_label(picks[at], book, label, (int)sizeof(label));
+  mu_layout_row(ctx, 2, (int[]){ 220, -1 }, 22);
+  if (mu_button_ex(ctx, label, 0, 0)) at = (at + 1) % npicks;
+  scr->vega_level = picks[at].level;
+  scr->vega_key   = picks[at].key;
+
+  VegaMatrix m;
+  vega_matrix(vc, scr->vega_level, scr->vega_key, &m);
+
+  char note[96];
+  snprintf(note, sizeof(note), "%d swaptions, updated per vol tick (%u rebuilds)",
+           m.count, vc->rebuilds);
+  mu_label(ctx, note);
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, 1);
+  mu_draw_rect(ctx, mu_layout_next(ctx), TH_SEPARATOR);
+
+  /* Shade against the largest node of the slice on display */
+  double scale = 0;
+  for (int e = 0; e < VEGA_EXPIRIES; e++) {
+    for (int t = 0; t < VEGA_TENORS; t++) {
+      double a = m.v[e][t] < 0 ? -m.v[e][t] : m.v[e][t];
+      if (a > scale) scale = a;
+    }
+  }
+
+  int widths[VEGA_TENORS + 2];
+  widths[0] = VEGA_HEAD_W;
+  for (int t = 0; t <= VEGA_TENORS; t++) widths[t + 1] = VEGA_CELL_W;
+
+  mu_layout_row(ctx, 1, (int[]){ -1 }, -20);
+  mu_begin_panel(ctx, "vega");
+
+  /* ---- Tenor heads ---- */
+  mu_layout_row(ctx, VEGA_TENORS + 2, widths, ROW_H);
+  tbl_cell(ctx, "EXP \\ TENOR", TH_HEADER_BG, TH_HEADER_TEXT, 0);
+  for (int t = 0; t < VEGA_TENORS; t++) {
+    tbl_cell(ctx, VEGA_TENOR_LABELS[t], TH_HEADER_BG, TH_HEADER_TEXT, MU_OPT_ALIGNRIGHT);
+  }
+  tbl_cell(ctx, "TOTAL", TH_HEADER_BG, TH_HEADER_TEXT, MU_OPT_ALIGNRIGHT);
+
+  /* ---- One line per expiry, with its total ---- */
+  for (int e = 0; e < VEGA_EXPIRIES; e++) {
+    mu_layout_row(ctx, VEGA_TENORS + 2, widths, ROW_H + 4);
+    tbl_cell(ctx, VEGA_EXPIRY_LABELS[e], TH_HEADER_BG, TH_HEADER_TEXT, 0);
+    for (int t = 0; t < VEGA_TENORS; t++) vega_cell(ctx, m.v[e][t], scale, TH_TEXT_BRIGHT);
+    tbl_cell_num(ctx, m.expiry[e], 1, 0, TH_SUMMARY_BG, TH_TEXT_BRIGHT);
+  }
+
+  /* ---- Tenor totals and the slice total ---- */
+  mu_layout_row(ctx, VEGA_TENORS + 2, widths, ROW_H + 2);
+  tbl_cell(ctx, "TOTAL", TH_SUMMARY_BG, TH_HEADER_TEXT, 0);
+  for (int t = 0; t < VEGA_TENORS; t++) {
+    tbl_cell_num(ctx, m.tenor[t], 1, 0, TH_SUMMARY_BG, TH_TEXT_BRIGHT);
+  }
+  tbl_cell_num(ctx, m.total, 1, 0, TH_SUMMARY_BG, TH_TEXT_BRIGHT);
+
+  mu_end_panel(ctx);
+
+  draw_status(ctx, book);
 }
@@ -12,8 +12,23 @@
 #include "bbg_tui.h"
 #include "data.h"
 #include "screen.h"
+#include "movers.h"
+#include "vega.h"
 
 /* ---- Render the POMS grid for the active screen ---- */
 void poms_render(mu_Context *ctx, Screen *scr, PositionBook *book, int tick);
 
+/* ---- Render a movers screen: top rows per metric, side by side ---- */
+void poms_render_movers(mu_Context *ctx, Movers *m, const PositionBook *book);
+
+/* ---- Render a pivot screen: its cube, with row / column / grand totals ---- */
+void poms_render_pivot(mu_Context *ctx, Screen *scr, const PositionBook *book);
+
+/* ---- Render a ladder screen: bucketed DV01 per group of its filtered rows ---- */
+void poms_render_ladder(mu_Context *ctx, Screen *scr, const PositionBook *book);
+
+/* ---- Render a vega screen: heat-mapped expiry x tenor matrix of one slice ---- */
+void poms_render_vega(mu_Context *ctx, Screen *scr, const VegaCube *vc,
+                      const PositionBook *book);
+
 #endif
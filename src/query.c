@@ -0,0 +1,443 @@
+/*
+** query.c — Filter Expression Language: parser, compiler, column kernels
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "query.h"
+#include "strmatch.h"
+
+/* ============================================================================
+**  Tokenizer
+** ============================================================================*/
+
+typedef enum {
+  TK_END, TK_WORD, TK_STR, TK_COLON, TK_CMP, TK_LP, TK_RP,
+  TK_AND, TK_OR, TK_NOT, TK_BAD
+} TokKind;
+
+typedef struct {
+  TokKind kind;
+  QryCmp  cmp;
+  char    text[QRY_TEXT_LEN];
+} Token;
+
+typedef struct {
+  const char         *src;
+  int                 pos;
+  Token               tok;          /* current lookahead */
+  Query              *q;
+  const PositionBook *book;
+} Parser;
+
+static int is_delim(char c) {
+  return c == '\0' || c == ' ' || c == '\t' || strchr(":<>=!()&|\"", c) != NULL;
+}
+
+static char lower_c(char c) {
+  return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+static int eq_ci(const char *a, const char *b) {
+  for (; *a && *b; a++, b++) {
+    if (lower_c(*a) != lower_c(*b)) return 0;
+  }
+  return *a == *b;
+}
+
+/* First n bytes equal, case-insensitively (a string ending early differs) */
+static int eqn_ci(const char *a, const char *b, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (lower_c(a[i]) != lower_c(b[i])) return 0;
+    if (a[i] == '\0') return 1;
+  }
+  return 1;
+}
+
+static void next_token(Parser *ps) {
+  const char *s = ps->src;
+  Token *t = &ps->tok;
+  int i = ps->pos;
+
+  while (s[i] == ' ' || s[i] == '\t') i++;
+  t->text[0] = '\0';
+  t->kind = TK_BAD;
+
+  char c = s[i];
+  if (!c)                          { t->kind = TK_END; }
+  else if (c == ':')               { t->kind = TK_COLON; i++; }
+  else if (c == '(')               { t->kind = TK_LP; i++; }
+  else if (c == ')')               { t->kind = TK_RP; i++; }
+  else if (c == '&' && s[i+1] == '&') { t->kind = TK_AND; i += 2; }
+  else if (c == '|' && s[i+1] == '|') { t->kind = TK_OR;  i += 2; }
+  else if (c == '<' || c == '>' || c == '=' || c == '!') {
+    int eq = (s[i+1] == '=');
+    t->kind = TK_CMP;
+    switch (c) {
+      case '<': t->cmp = eq ? QCMP_LE : QCMP_LT; break;
+      case '>': t->cmp = eq ? QCMP_GE : QCMP_GT; break;
+      case '=': t->cmp = QCMP_EQ; break;          /* = or == */
+      default:  if (eq) t->cmp = QCMP_NE; else t->kind = TK_NOT; break;
+    }
+    i += 1 + eq;
+  }
+  else if (c == '"') {
+    int n = 0;
+    i++;
+    while (s[i] && s[i] != '"') {
+      if (n < QRY_TEXT_LEN - 1) t->text[n++] = s[i];
+      i++;
+    }
+    t->text[n] = '\0';
+    if (s[i] == '"') { t->kind = TK_STR; i++; }
+  }
+  else if (!is_delim(c)) {
+    int n = 0;
+    while (!is_delim(s[i])) {
+      if (n < QRY_TEXT_LEN - 1) t->text[n++] = s[i];
+      i++;
+    }
+    t->text[n] = '\0';
+    if      (eq_ci(t->text, "and")) t->kind = TK_AND;
+    else if (eq_ci(t->text, "or"))  t->kind = TK_OR;
+    else if (eq_ci(t->text, "not")) t->kind = TK_NOT;
+    else                            t->kind = TK_WORD;
+  }
+  ps->pos = i;
+}
+
+
+/* ============================================================================
+**  Field Names
+** ============================================================================*/
+
+static const struct { const char *name; NumField f; } NUM_FIELDS[] = {
+  { "notional", FIELD_NOTIONAL },     { "notl",     FIELD_NOTIONAL },
+  { "avg",      FIELD_AVG_PRICE },    { "mkt",      FIELD_MKT_PRICE },
+  { "px",       FIELD_MKT_PRICE },    { "pnl",      FIELD_PNL_TOTAL },
+  { "pnl_day",  FIELD_PNL_DAY },      { "dpnl",     FIELD_PNL_DAY },
+  { "realized", FIELD_PNL_REALIZED }, { "dv01",     FIELD_DV01 },
+  { "cs01",     FIELD_CS01 },         { "delta",    FIELD_DELTA },
+  { "gamma",    FIELD_GAMMA },        { "vega",     FIELD_VEGA },
+  { "theta",    FIELD_THETA },
+};
+
+static const struct { const char *name; QryCol c; } TEXT_FIELDS[] = {
+  { "desk",  QCOL_DESK },  { "book",  QCOL_BOOK },  { "class", QCOL_CLASS },
+  { "type",  QCOL_CLASS }, { "inst",  QCOL_INST },  { "cusip", QCOL_CUSIP },
+};
+
+#define COUNT_OF(a) (int)(sizeof(a) / sizeof(a[0]))
+
+
+/* ============================================================================
+**  Parser → postfix program
+** ============================================================================*/
+
+static int fail(Parser *ps, const char *msg) {
+  if (!ps->q->err[0]) snprintf(ps->q->err, QRY_ERR_LEN, "%s", msg);
+  return -1;
+}
+
+static QryInstr *emit(Parser *ps, QryOp op) {
+  Query *q = ps->q;
+  if (q->n >= QRY_MAX_CODE) { fail(ps, "query too long"); return NULL; }
+  QryInstr *in = &q->code[q->n++];
+  memset(in, 0, sizeof(*in));
+  in->op = (uint8_t)op;
+  return in;
+}
+
+/* Resolve a desk/book value to the set of dictionary ids it names */
+static void resolve_names(uint64_t *ids, const NameDict *d, const char *val,
+                          const char *(*short_code)(const char *))
+{
+  char lv[QRY_TEXT_LEN];
+  sm_lower(lv, (int)sizeof(lv), val);
+  for (int i = 0; i < d->count; i++) {
+    if (eq_ci(short_code(d->names[i]), val) ||
+        sm_contains_ci(d->names[i], lv))
+    {
+      sel_set(ids, i);
+    }
+  }
+}
+
+static void resolve_class(uint64_t *ids, const char *val) {
+  size_t n = strlen(val);
+  for (int a = 0; a < ASSET_CLASS_COUNT; a++) {
+    if (n && eqn_ci(ASSET_CLASS_NAMES[a], val, n)) sel_set(ids, a);
+  }
+}
+
+static int parse_expr(Parser *ps, int depth);
+
+static int parse_pred(Parser *ps) {
+  Token v = ps->tok;
+  next_token(ps);
+
+  if (v.kind == TK_WORD && ps->tok.kind == TK_COLON) {
+    next_token(ps);
+    if (ps->tok.kind != TK_WORD && ps->tok.kind != TK_STR)
+      return fail(ps, "expected value after ':'");
+    Token val = ps->tok;
+    next_token(ps);
+
+    for (int i = 0; i < COUNT_OF(TEXT_FIELDS); i++) {
+      if (!eq_ci(v.text, TEXT_FIELDS[i].name)) continue;
+      QryCol col = TEXT_FIELDS[i].c;
+      QryInstr *in = emit(ps, (col == QCOL_INST || col == QCOL_CUSIP)
+                              ? QOP_FIELD_TEXT : QOP_ID);
+      if (!in) return -1;
+      in->field = (uint8_t)col;
+      sm_lower(in->text, QRY_TEXT_LEN, val.text);
+      if (col == QCOL_DESK)  resolve_names(in->ids, &ps->book->desks, val.text, data_desk_short);
+      if (col == QCOL_BOOK)  resolve_names(in->ids, &ps->book->books, val.text, data_book_short);
+      if (col == QCOL_CLASS) resolve_class(in->ids, val.text);
+      return 0;
+    }
+    return fail(ps, "unknown field");
+  }
+
+  if (v.kind == TK_WORD && ps->tok.kind == TK_CMP) {
+    QryCmp cmp = ps->tok.cmp;
+    next_token(ps);
+    if (ps->tok.kind != TK_WORD) return fail(ps, "expected number");
+    char *end;
+    double x = strtod(ps->tok.text, &end);
+    if (end == ps->tok.text || *end) return fail(ps, "bad number");
+    next_token(ps);
+
+    for (int i = 0; i < COUNT_OF(NUM_FIELDS); i++) {
+      if (!eq_ci(v.text, NUM_FIELDS[i].name)) continue;
+      QryInstr *in = emit(ps, QOP_NUM);
+      if (!in) return -1;
+      in->field = (uint8_t)NUM_FIELDS[i].f;
+      in->cmp   = (uint8_t)cmp;
+      in->value = x;
+      return 0;
+    }
+    return fail(ps, "unknown field");
+  }
+
+  if (v.kind == TK_WORD || v.kind == TK_STR) {
+    QryInstr *in = emit(ps, QOP_TEXT);
+    if (!in) return -1;
+    sm_lower(in->text, QRY_TEXT_LEN, v.text);
+    return 0;
+  }
+  return fail(ps, "syntax error");
+}
+
+static int parse_factor(Parser *ps, int depth) {
+  if (depth > QRY_MAX_DEPTH) return fail(ps, "nested too deep");
+
+  if (ps->tok.kind == TK_NOT) {
+    next_token(ps);
+    if (parse_factor(ps, depth + 1)) return -1;
+    return emit(ps, QOP_NOT) ? 0 : -1;
+  }
+  if (ps->tok.kind == TK_LP) {
+    next_token(ps);
+    if (parse_expr(ps, depth + 1)) return -1;
+    if (ps->tok.kind != TK_RP) return fail(ps, "missing ')'");
+    next_token(ps);
+    return 0;
+  }
+  return parse_pred(ps);
+}
+
+static int starts_factor(TokKind k) {
+  return k == TK_WORD || k == TK_STR || k == TK_LP || k == TK_NOT;
+}
+
+static int parse_term(Parser *ps, int depth) {
+  if (parse_factor(ps, depth)) return -1;
+  for (;;) {
+    if (ps->tok.kind == TK_AND) next_token(ps);
+    else if (!starts_factor(ps->tok.kind)) return 0;
+    if (parse_factor(ps, depth)) return -1;
+    if (!emit(ps, QOP_AND)) return -1;
+  }
+}
+
+static int parse_expr(Parser *ps, int depth) {
+  if (parse_term(ps, depth)) return -1;
+  while (ps->tok.kind == TK_OR) {
+    next_token(ps);
+    if (parse_term(ps, depth)) return -1;
+    if (!emit(ps, QOP_OR)) return -1;
+  }
+  return 0;
+}
+
+/* Peak operand-stack depth of the postfix program (-1 if malformed) */
+static int stack_need(const Query *q) {
+  int d = 0, peak = 0;
+  for (int i = 0; i < q->n; i++) {
+    switch (q->code[i].op) {
+      case QOP_AND: case QOP_OR: d--; break;
+      case QOP_NOT: break;
+      default:      d++; break;
+    }
+    if (d > peak) peak = d;
+    if (d < 1) return -1;
+  }
+  return d == 1 ? peak : -1;
+}
+
+
+int qry_is_query(const char *src) {
+  /* Parens alone don't count: "TY H6 (10Y Fut)" is a name, not a query */
+  Parser ps = { .src = src };
+  for (next_token(&ps); ps.tok.kind != TK_END; next_token(&ps)) {
+    switch (ps.tok.kind) {
+      case TK_COLON: case TK_CMP: case TK_AND: case TK_OR: case TK_NOT: case TK_STR:
+        return 1;
+      default: break;
+    }
+  }
+  return 0;
+}
+
+
+int qry_compile(Query *q, const char *src, const PositionBook *book) {
+  Parser ps = { .src = src, .q = q, .book = book };
+  q->n = 0;
+  q->err[0] = '\0';
+
+  next_token(&ps);
+  if (ps.tok.kind == TK_END) return fail(&ps, "empty query");
+  if (parse_expr(&ps, 0)) return -1;
+  if (ps.tok.kind != TK_END) return fail(&ps, "unexpected token");
+  if (stack_need(q) < 0 || stack_need(q) > QRY_MAX_DEPTH)
+    return fail(&ps, "query too complex");
+  return 0;
+}
+
+
+int qry_uses_values(const Query *q) {
+  for (int i = 0; i < q->n; i++) {
+    if (q->code[i].op == QOP_NUM) return 1;
+  }
+  return 0;
+}
+
+
+/* ============================================================================
+**  Column Kernels — one selection word (64 rows) at a time
+** ============================================================================*/
+
+#define WORD_LIM(k, n)  (((n) - (k) * 64 < 64) ? (n) - (k) * 64 : 64)
+
+#define NUM_KERNEL(OP)                                               \
+  for (int k = 0; k < words; k++) {                                  \
+    const double *x = col + k * 64;                                  \
+    int lim = WORD_LIM(k, n);                                        \
+    uint64_t w = 0;                                                  \
+    for (int j = 0; j < lim; j++) w |= (uint64_t)(x[j] OP v) << j;   \
+    out[k] = w;                                                      \
+  }
+
+static void eval_num(const double *col, QryCmp cmp, double v, int n, uint64_t *out) {
+  int words = SEL_WORDS(n);
+  switch (cmp) {
+    case QCMP_LT: NUM_KERNEL(<);  break;
+    case QCMP_LE: NUM_KERNEL(<=); break;
+    case QCMP_GT: NUM_KERNEL(>);  break;
+    case QCMP_GE: NUM_KERNEL(>=); break;
+    case QCMP_EQ: NUM_KERNEL(==); break;
+    case QCMP_NE: NUM_KERNEL(!=); break;
+  }
+}
+
+/* Id set → OR of the book's precomputed per-id row bitmaps */
+static void eval_id(const uint64_t (*sets)[SEL_WORDS(MAX_POSITIONS)], int n_ids,
+                    const uint64_t *ids, int n, uint64_t *out)
+{
+  sel_clear(out, n);
+  for (int k = 0; k < SEL_WORDS(n_ids); k++) {
+    uint64_t w = ids[k];
+    while (w) {
+      int id = k * 64 + __builtin_ctzll(w);
+      w &= w - 1;
+      if (id < n_ids) sel_or(out, out, sets[id], n);
+    }
+  }
+}
+
+/* Any text field: trigram candidates, verified on the lowercased text */
+static void eval_text(const TrigramIndex *ix, const char *nd, int n, uint64_t *out) {
+  int nlen = (int)strlen(nd);
+  if (!tri_candidates(ix, nd, out)) sel_fill(out, n);
+  for (int k = 0; k < SEL_WORDS(n); k++) {
+    uint64_t w = out[k];
+    while (w) {
+      int i = k * 64 + __builtin_ctzll(w);
+      w &= w - 1;
+      if (!tri_row_match(ix, i, nd, nlen)) sel_reset(out, i);
+    }
+  }
+}
+
+static void eval_field_text(const PositionBook *book, QryCol col, const char *nd,
+                            int n, uint64_t *out)
+{
+  sel_clear(out, n);
+  for (int i = 0; i < n; i++) {
+    const Position *p = &book->items[i];
+    const char *s = (col == QCOL_CUSIP) ? p->cusip : p->instrument;
+    if (sm_contains_ci(s, nd)) sel_set(out, i);
+  }
+}
+
+
+void qry_eval(const Query *q, const PositionBook *book, const TrigramIndex *ix,
+              uint64_t *out)
+{
+  uint64_t stack[QRY_MAX_DEPTH][SEL_WORDS(MAX_POSITIONS)];
+  const BookColumns *cols = &book->cols;
+  int n = book->count, words = SEL_WORDS(n), sp = 0;
+
+  for (int pc = 0; pc < q->n; pc++) {
+    const QryInstr *in = &q->code[pc];
+
+    switch ((QryOp)in->op) {
+      case QOP_NUM:
+        eval_num(cols->f64[in->field], (QryCmp)in->cmp, in->value, n, stack[sp++]);
+        break;
+      case QOP_ID: {
+        const BookBitmaps *bs = &book->sets;
+        if (in->field == QCOL_DESK)
+          eval_id(bs->desk, book->desks.count, in->ids, n, stack[sp++]);
+        else if (in->field == QCOL_BOOK)
+          eval_id(bs->book, book->books.count, in->ids, n, stack[sp++]);
+        else
+          eval_id(bs->asset, ASSET_CLASS_COUNT, in->ids, n, stack[sp++]);
+        break;
+      }
+      case QOP_TEXT:
+        eval_text(ix, in->text, n, stack[sp++]);
+        break;
+      case QOP_FIELD_TEXT:
+        eval_field_text(book, (QryCol)in->field, in->text, n, stack[sp++]);
+        break;
+      case QOP_AND:
+        sp--;
+        for (int k = 0; k < words; k++) stack[sp - 1][k] &= stack[sp][k];
+        break;
+      case QOP_OR:
+        sp--;
+        for (int k = 0; k < words; k++) stack[sp - 1][k] |= stack[sp][k];
+        break;
+      case QOP_NOT:
+        for (int k = 0; k < words; k++) stack[sp - 1][k] = ~stack[sp - 1][k];
+        if (n & 63) stack[sp - 1][words - 1] &= (1ull << (n & 63)) - 1;
+        break;
+    }
+  }
+
+  if (sp == 1) memcpy(out, stack[0], sizeof(uint64_t) * (size_t)words);
+  else         sel_clear(out, n);
+}
@@ -0,0 +1,87 @@
+/*
+** query.h — Filter Expression Language
+**
+** Grammar (keywords case-insensitive; `&&` `||` `!` also accepted):
+**
+**   expr    := term   { "or"  term }
+**   term    := factor { ["and"] factor }        juxtaposition means and
+**   factor  := "not" factor | "(" expr ")" | pred
+**   pred    := NUMFIELD CMP NUMBER              dv01 > 5000, pnl_day < 0
+**            | TEXTFIELD ":" VALUE              desk:USR, book:"Vol Desk"
+**            | VALUE                            substring of any text field
+**   CMP     := < <= > >= = == !=
+**
+**   NUMFIELD  notional avg mkt pnl pnl_day realized dv01 cs01 delta
+**             gamma vega theta
+**   TEXTFIELD desk book class inst cusip
+**
+** desk:/book: match the short code exactly ("USR") or the full name as a
+** substring ("rates"); class: matches an asset-class name prefix ("fut").
+** All comparisons are case-insensitive.
+**
+** qry_compile() is a recursive-descent parser that emits the expression
+** tree in postfix order, so the compiled Query is a flat program. Name
+** lookups (desk/book/class) are resolved to id sets at compile time and
+** evaluate as ORs of the book's precomputed per-id bitmaps (BookBitmaps);
+** numeric terms are column-at-a-time kernels over BookColumns. Every term
+** yields a selection bitmap, combined word-wise with AND/OR/NOT. No
+** per-row interpretation.
+*/
+
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stdint.h>
+#include "data.h"
+#include "sel.h"
+#include "trigram.h"
+
+#define QRY_MAX_CODE   32
+#define QRY_MAX_DEPTH  16
+#define QRY_TEXT_LEN   64
+#define QRY_ERR_LEN    48
+
+typedef enum {
+  QOP_NUM,          /* f64[field] CMP value                  */
+  QOP_ID,           /* row's desk/book/class id in id set    */
+  QOP_TEXT,         /* substring of any text field (trigram) */
+  QOP_FIELD_TEXT,   /* substring of one text field           */
+  QOP_AND,
+  QOP_OR,
+  QOP_NOT
+} QryOp;
+
+typedef enum { QCMP_LT, QCMP_LE, QCMP_GT, QCMP_GE, QCMP_EQ, QCMP_NE } QryCmp;
+
+/* Text / id columns a predicate can address */
+typedef enum { QCOL_DESK, QCOL_BOOK, QCOL_CLASS, QCOL_INST, QCOL_CUSIP } QryCol;
+
+typedef struct {
+  uint8_t   op;                               /* QryOp                   */
+  uint8_t   cmp;                              /* QryCmp   (QOP_NUM)      */
+  uint8_t   field;                            /* NumField or QryCol      */
+  double    value;                            /* QOP_NUM                 */
+  uint64_t  ids[SEL_WORDS(MAX_POSITIONS)];    /* QOP_ID: accepted ids    */
+  char      text[QRY_TEXT_LEN];               /* lowercased substring    */
+} QryInstr;
+
+typedef struct {
+  QryInstr  code[QRY_MAX_CODE];
+  int       n;
+  char      err[QRY_ERR_LEN];                 /* "" when compiled OK     */
+} Query;
+
+/* ---- 1 if src uses query syntax (field:, comparison, and/or/not, "quotes"); parens alone don't count ---- */
+int  qry_is_query(const char *src);
+
+/* ---- Compile src against book's name tables. Returns 0, or -1 with q->err set. ---- */
+int  qry_compile(Query *q, const char *src, const PositionBook *book);
+
+/* ---- 1 if the compiled query compares numeric (live) columns ---- */
+int  qry_uses_values(const Query *q);
+
+/* ---- Evaluate over rows [0, book->count) into out (tail bits clear) ---- */
+void qry_eval(const Query *q, const PositionBook *book, const TrigramIndex *ix,
+              uint64_t *out);
+
+#endif
@@ -16,10 +16,16 @@
 #include <ctype.h>
 #include "screen.h"
 #include "theme.h"
+#include "trigram.h"
+#include "strmatch.h"
+#include "worker.h"
+#include "agg.h"
 
 /* ---- Double-click detection ---- */
 #define DBLCLICK_FRAMES 18  /* ~300ms at 60fps */
 
+static void view_release(int v);
+
 
 void screen_mgr_init(ScreenManager *mgr) {
   memset(mgr, 0, sizeof(*mgr));
@@ -53,12 +59,15 @@ int screen_mgr_add_preset(ScreenManager *mgr, const char *name,
   } else {
     snprintf(s->name, SCREEN_NAME_LEN, "POMS %d", mgr->next_id);
   }
+  s->uid = (unsigned)mgr->next_id;
   mgr->next_id++;
 
   s->filter.show_bonds     = bonds;
   s->filter.show_swaps     = swaps;
   s->filter.show_futures   = futures;
   s->filter.show_swaptions = swaptions;
+  s->view                  = -1;
+  s->group                 = (GroupSpec){ { GROUP_BOOK, GROUP_DESK }, 2 };
   s->selected_row          = -1;
   s->active                = 1;
 
@@ -69,6 +78,47 @@ int screen_mgr_add_preset(ScreenManager *mgr, const char *name,
 }
 
 
+int screen_mgr_add_movers(ScreenManager *mgr, const char *name) {
+  int idx = screen_mgr_add_preset(mgr, name, 0, 0, 0, 0);
+  if (idx >= 0) mgr->screens[idx].kind = SCREEN_MOVERS;
+  return idx;
+}
+
+
+int screen_mgr_add_pivot(ScreenManager *mgr, const char *name, const PivotDef *def,
+                         PivotMeasure measure)
+{
+  int idx = screen_mgr_add_preset(mgr, name, 0, 0, 0, 0);
+  if (idx >= 0) {
+    Screen *s = &mgr->screens[idx];
+    s->kind          = SCREEN_PIVOT;
+    s->pivot_def     = *def;
+    s->pivot_measure = measure;
+  }
+  return idx;
+}
+
+
+int screen_mgr_add_ladder(ScreenManager *mgr, const char *name,
+                          int bonds, int swaps, int futures, int swaptions)
+{
+  int idx = screen_mgr_add_preset(mgr, name, bonds, swaps, futures, swaptions);
+  if (idx >= 0) {
+    Screen *s = &mgr->screens[idx];
+    s->kind  = SCREEN_LADDER;
+    s->group = (GroupSpec){ { GROUP_DESK }, 1 };
+  }
+  return idx;
+}
+
+
+int screen_mgr_add_vega(ScreenManager *mgr, const char *name) {
+  int idx = screen_mgr_add_preset(mgr, name, 0, 0, 0, 0);
+  if (idx >= 0) mgr->screens[idx].kind = SCREEN_VEGA;
+  return idx;
+}
+
+
 void screen_mgr_remove(ScreenManager *mgr, int idx) {
   if (mgr->count <= 1) return;
   if (idx < 0 || idx >= mgr->count) return;
@@ -81,6 +131,8 @@ void screen_mgr_remove(ScreenManager *mgr, int idx) {
   if (mgr->close_confirm_idx == idx) mgr->close_confirm_idx = -1;
   else if (mgr->close_confirm_idx > idx) mgr->close_confirm_idx--;
 
+  view_release(mgr->screens[idx].view);
+
   for (int i = idx; i < mgr->count - 1; i++) {
     mgr->screens[i] = mgr->screens[i + 1];
   }
@@ -98,7 +150,8 @@ void screen_mgr_swap(ScreenManager *mgr, int a, int b) {
   if (b < 0 || b >= mgr->count) return;
   if (a == b) return;
 
-  Screen tmp = mgr->screens[a];
+  static Screen tmp;            /* too big for the stack (ScreenGroups) */
+  tmp = mgr->screens[a];
   mgr->screens[a] = mgr->screens[b];
   mgr->screens[b] = tmp;
 
@@ -135,6 +188,11 @@ int screen_mgr_tab_bar(ScreenManager *mgr, mu_Context *ctx) {
   int add_w = 25;
   int n = mgr->count;
 
+  /* With many tabs, narrow them rather than push [+] off the bar */
+  int room = mu_get_current_container(ctx)->body.w - add_w -
+             (n + 2) * ctx->style->spacing - 2 * ctx->style->padding;
+  if (n > 0 && room / n < tab_w) tab_w = room / n;
+
   /* Column widths: tabs + [+] + spacer */
   int widths[MAX_SCREENS + 2];
   for (int i = 0; i < n; i++) widths[i] = tab_w;
@@ -379,44 +437,410 @@ int screen_mgr_tab_bar(ScreenManager *mgr, mu_Context *ctx) {
 **  Filter Matching
 ** ============================================================================*/
 
-static int str_contains_ci(const char *haystack, const char *needle) {
-  if (!needle[0]) return 1;
-  int nlen = (int)strlen(needle);
-  int hlen = (int)strlen(haystack);
-  if (nlen > hlen) return 0;
-
-  for (int i = 0; i <= hlen - nlen; i++) {
-    int match = 1;
-    for (int j = 0; j < nlen && match; j++) {
-      char a = haystack[i + j];
-      char b = needle[j];
-      if (a >= 'A' && a <= 'Z') a = (char)(a + 32);
-      if (b >= 'A' && b <= 'Z') b = (char)(b + 32);
-      if (a != b) match = 0;
+static int class_visible(const ScreenFilter *f, AssetClass ac) {
+  switch (ac) {
+    case ASSET_GOVT_BOND: return f->show_bonds;
+    case ASSET_IRS:
+    case ASSET_FRA:       return f->show_swaps;
+    case ASSET_FUTURES:   return f->show_futures;
+    case ASSET_SWAPTION:  return f->show_swaptions;
+    default:              return 1;
+  }
+}
+
+
+/* Rows whose asset class is ticked: OR of the book's precomputed bitmaps */
+static void class_mask(uint64_t *out, const ScreenFilter *f, const PositionBook *book) {
+  int n = book->count;
+  sel_clear(out, n);
+  for (int c = 0; c < ASSET_CLASS_COUNT; c++) {
+    if (class_visible(f, (AssetClass)c)) sel_or(out, out, book->sets.asset[c], n);
+  }
+}
+
+
+void screen_filter_touch(Screen *scr) {
+  scr->filter_epoch++;
+}
+
+
+/* True if every row passing f also passed m->built, so the cached rows
+   can be refined in place: no asset class re-enabled, and the previous
+   (non-empty) substring is a substring of the new one. Structured queries
+   don't narrow by extension ("dv01 > 5" → "dv01 > 50"), so never refine. */
+static int narrows(const ScreenMatch *m, const ScreenFilter *f, const char *nd) {
+  const ScreenFilter *b = &m->built;
+  if (qry_is_query(nd) || qry_is_query(b->search)) return 0;
+  if (f->show_bonds     && !b->show_bonds)     return 0;
+  if (f->show_swaps     && !b->show_swaps)     return 0;
+  if (f->show_futures   && !b->show_futures)   return 0;
+  if (f->show_swaptions && !b->show_swaptions) return 0;
+  if (!b->search[0]) return !nd[0];     /* whole book: trigrams do better */
+  return strstr(nd, b->search) != NULL;
+}
+
+
+/* Up to date for this definition and these rows (and values, if it reads them) */
+static int match_current(const ScreenView *v, const PositionBook *book) {
+  const ScreenMatch *m = &v->match;
+  return m->valid &&
+         m->filter_epoch == v->uid &&
+         m->struct_epoch == book->struct_epoch &&
+         m->book_count   == book->count &&
+         (!m->uses_values || m->value_epoch == book->value_epoch);
+}
+
+
+void screen_match_build(ScreenMatch *m, const ScreenFilter *f, unsigned filter_epoch,
+                        const PositionBook *book, TrigramIndex *ix, Query *q)
+{
+  int n = book->count;
+  int same_rows = m->valid &&
+                  m->struct_epoch == book->struct_epoch &&
+                  m->book_count   == n;
+
+  /* Book delta: rows are append-only, so with the filter unchanged (and
+     not reading live values) rows below the previous count are already
+     exact; only the appended rows need verifying. */
+  int from = (m->valid && !same_rows && !m->uses_values &&
+              m->filter_epoch == filter_epoch && m->book_count < n)
+             ? m->book_count : 0;
+  uint64_t prev[SEL_WORDS(MAX_POSITIONS)];
+  int      prev_count = m->count;
+  if (from) sel_copy(prev, m->sel, from);
+
+  char nd[sizeof(f->search)];
+  int  nlen = sm_lower(nd, (int)sizeof(nd), f->search);
+  tri_sync(ix, book);
+
+  uint64_t cls[SEL_WORDS(MAX_POSITIONS)];
+  class_mask(cls, f, book);
+
+  /* A narrowing edit refines the previous result (m->sel as is). Otherwise
+     a full pass: a query compiles to column kernels that produce the
+     bitmap directly; a plain substring narrows by trigram postings. */
+  if (!(same_rows && narrows(m, f, nd))) {
+    m->err[0] = '\0';
+    m->uses_values = 0;
+    if (qry_is_query(f->search)) {
+      if (qry_compile(q, f->search, book) == 0) {
+        qry_eval(q, book, ix, m->sel);
+        m->uses_values = qry_uses_values(q);
+      } else {
+        sel_clear(m->sel, n);
+        snprintf(m->err, sizeof(m->err), "%s", q->err);
+      }
+      nlen = 0;                         /* text terms already applied */
+    } else if (!tri_candidates(ix, nd, m->sel)) {
+      sel_fill(m->sel, n);
+    }
+  }
+
+  /* Asset-class toggles are one bitmap AND; substring candidates are then
+     verified against the index's pre-lowercased text */
+  sel_and(m->sel, m->sel, cls, n);
+  if (from) {
+    int k = from >> 6;
+    memcpy(m->sel, prev, sizeof(uint64_t) * (size_t)k);
+    if (from & 63) {
+      uint64_t lo = (1ULL << (from & 63)) - 1;
+      m->sel[k] = (prev[k] & lo) | (m->sel[k] & ~lo);
     }
-    if (match) return 1;
   }
+  m->count = from ? prev_count : 0;     /* rows[] below `from` kept as is */
+  for (int k = from >> 6; k < SEL_WORDS(n); k++) {
+    uint64_t w = m->sel[k];
+    if (k == from >> 6) w &= ~((1ULL << (from & 63)) - 1);
+    while (w) {
+      int i = k * 64 + __builtin_ctzll(w);
+      w &= w - 1;
+      if (!nlen || tri_row_match(ix, i, nd, nlen)) {
+        m->rows[m->count++] = i;
+      } else {
+        sel_reset(m->sel, i);
+      }
+    }
+  }
+
+  m->built = *f;
+  memcpy(m->built.search, nd, sizeof(nd));
+  m->valid        = 1;
+  m->filter_epoch = filter_epoch;
+  m->struct_epoch = book->struct_epoch;
+  m->value_epoch  = book->value_epoch;
+  m->book_count   = n;
+}
+
+
+/* ============================================================================
+**  Materialized Views
+** ============================================================================*/
+
+/* Process-wide: every screen (of any manager) shares one table */
+static ScreenView s_views[MAX_VIEWS];
+static unsigned   s_view_uid = 1;
+
+/* Definition key: search lowercased, so "UST" and "ust" share a view */
+static void view_key(ScreenFilter *out, const ScreenFilter *f) {
+  *out = *f;
+  sm_lower(out->search, (int)sizeof(out->search), f->search);
+}
+
+static int same_def(const ScreenFilter *a, const ScreenFilter *b) {
+  return strcmp(a->search, b->search) == 0 &&
+         a->show_bonds     == b->show_bonds     &&
+         a->show_swaps     == b->show_swaps     &&
+         a->show_futures   == b->show_futures   &&
+         a->show_swaptions == b->show_swaptions;
+}
+
+static int view_find(const ScreenFilter *def) {
+  for (int i = 0; i < MAX_VIEWS; i++) {
+    if (s_views[i].used && same_def(&s_views[i].def, def)) return i;
+  }
+  return -1;
+}
+
+/* New view for def; seed (may be NULL) is a previous result to refine */
+static int view_alloc(const ScreenFilter *def, const ScreenMatch *seed) {
+  for (int i = 0; i < MAX_VIEWS; i++) {
+    ScreenView *v = &s_views[i];
+    if (v->used) continue;
+    memset(v, 0, sizeof(*v));
+    v->used = 1;
+    v->uid  = s_view_uid++;
+    v->def  = *def;
+    if (seed) v->match = *seed;
+    return i;
+  }
+  return -1;
+}
+
+static void view_release(int v) {
+  if (v < 0) return;
+  ScreenView *vw = &s_views[v];
+  if (--vw->refs > 0 || vw->pinned) return;
+  worker_release(vw->uid);
+  vw->used = 0;
+}
+
+/* Redefine ad-hoc view v (held by one screen only) in place: a new uid
+   drops its in-flight job, and the old match stays as the refine seed */
+static void view_redefine(int v, const ScreenFilter *def) {
+  ScreenView *vw = &s_views[v];
+  worker_release(vw->uid);
+  vw->uid          = s_view_uid++;
+  vw->def          = *def;
+  vw->totals_valid = 0;
+  memset(&vw->req, 0, sizeof(vw->req));
+}
+
+/* Stand-in for a screen with no view (never used: see view_resolve) */
+static ScreenView s_no_view;
+
+/*
+** Attach scr to the view for its current filter (after an edit). A slot
+** is always there: at most SCREEN_MAX_NAMED views are pinned, every other
+** view is held by a screen, and a screen that is the only holder of its
+** ad-hoc view has it redefined in place rather than taking a second one.
+** Should the table be full anyway, the screen keeps what it had and
+** view_epoch is left alone so the next frame retries.
+*/
+static ScreenView *view_resolve(Screen *scr) {
+  if (scr->view >= 0 && scr->view_epoch == scr->filter_epoch) {
+    return &s_views[scr->view];
+  }
+
+  ScreenFilter def;
+  view_key(&def, &scr->filter);
+  int v   = view_find(&def);
+  int old = scr->view;
+  if (v < 0 && old >= 0 && s_views[old].refs == 1 && !s_views[old].pinned) {
+    view_redefine(old, &def);
+    v = old;
+  }
+  if (v < 0) v = view_alloc(&def, old >= 0 ? &s_views[old].match : NULL);
+  if (v < 0) return old >= 0 ? &s_views[old] : &s_no_view;
+
+  if (v != old) {
+    s_views[v].refs++;
+    view_release(old);
+    scr->view = v;
+  }
+  scr->view_epoch = scr->filter_epoch;
+  return &s_views[v];
+}
+
+
+int screen_view_define(const char *name, const ScreenFilter *f) {
+  ScreenFilter def;
+  view_key(&def, f);
+  int v = view_find(&def);
+  if (v < 0 || !s_views[v].pinned) {
+    int pinned = 0;
+    for (int i = 0; i < MAX_VIEWS; i++) pinned += s_views[i].used && s_views[i].pinned;
+    if (pinned >= SCREEN_MAX_NAMED) return -1;
+  }
+  if (v < 0) v = view_alloc(&def, NULL);
+  if (v < 0) return -1;
+  snprintf(s_views[v].name, sizeof(s_views[v].name), "%s", name);
+  s_views[v].pinned = 1;
   return 0;
 }
 
 
-int screen_filter_check(const ScreenFilter *f, const Position *p) {
-  switch (p->asset_class) {
-    case ASSET_GOVT_BOND: if (!f->show_bonds) return 0; break;
-    case ASSET_IRS:
-    case ASSET_FRA:       if (!f->show_swaps) return 0; break;
-    case ASSET_FUTURES:   if (!f->show_futures) return 0; break;
-    case ASSET_SWAPTION:  if (!f->show_swaptions) return 0; break;
-    default: break;
+/* Bring v's match up to date: submit a rebuild if stale, collect it if
+   landed. With block set, a view that has never been built waits for its
+   first result; otherwise it stays invalid until the job lands. */
+static void view_update(ScreenView *v, const PositionBook *book, int block) {
+  ScreenMatch   *m = &v->match;
+  ScreenRequest *r = &v->req;
+
+  if (match_current(v, book)) {
+    r->pending = 0;
+    return;
+  }
+
+  /* One job per distinct book state; while it runs, keep showing the
+     previous result. Value-driven queries resubmit only once the
+     in-flight job has landed, so ticks can't flood the worker. The
+     definition never changes, so r->filter_epoch is always v->uid. */
+  int moved = r->filter_epoch != v->uid ||
+              r->struct_epoch != book->struct_epoch ||
+              r->book_count   != book->count;
+  if (!r->pending || moved) {
+    r->gen          = worker_submit(v->uid, &v->def, v->uid, m, book);
+    r->filter_epoch = v->uid;
+    r->struct_epoch = book->struct_epoch;
+    r->book_count   = book->count;
+    r->pending      = 1;
   }
 
-  if (f->search[0]) {
-    if (str_contains_ci(p->instrument, f->search)) return 1;
-    if (str_contains_ci(p->cusip, f->search)) return 1;
-    if (str_contains_ci(p->book, f->search)) return 1;
-    if (str_contains_ci(p->desk, f->search)) return 1;
-    return 0;
+  if (block && !m->valid) {
+    worker_wait(v->uid, r->gen, m);           /* nothing to show yet */
+    r->pending = 0;
+    v->totals_valid = 0;
+  } else if (worker_collect(v->uid, r->gen, m)) {
+    r->pending = 0;
+    v->totals_valid = 0;
   }
+}
+
+
+const ScreenView* screen_view(Screen *scr, const PositionBook *book) {
+  ScreenView *v = view_resolve(scr);
+  if (v->used) view_update(v, book, 1);
+  return v;
+}
+
+
+const ScreenMatch* screen_match(Screen *scr, const PositionBook *book) {
+  return &screen_view(scr, book)->match;
+}
+
 
-  return 1;
+/* Footer / subtotal aggregates of the count rows in sel (rows below n) */
+static void totals_compute(ViewTotals *t, const PositionBook *book,
+                           const uint64_t *sel, int n, int count)
+{
+  const BookColumns *cols = &book->cols;
+  t->count    = count;
+  t->notional = agg_sum_money(cols, FIELD_NOTIONAL,  sel, n);
+  t->pnl      = agg_sum_money(cols, FIELD_PNL_TOTAL, sel, n);
+  t->pnl_day  = agg_sum_money(cols, FIELD_PNL_DAY,   sel, n);
+  t->dv01     = agg_sum(cols->f64[FIELD_DV01],  sel, n);
+  t->cs01     = agg_sum(cols->f64[FIELD_CS01],  sel, n);
+  t->vega     = agg_sum(cols->f64[FIELD_VEGA],  sel, n);
+  t->theta    = agg_sum(cols->f64[FIELD_THETA], sel, n);
+}
+
+
+const ViewTotals* screen_totals(Screen *scr, const PositionBook *book) {
+  ScreenView *v = view_resolve(scr);
+  if (v->totals_valid && v->totals_value_epoch == book->value_epoch) {
+    return &v->totals;
+  }
+
+  /* Rows the match was built over; later rows aren't in it yet */
+  totals_compute(&v->totals, book, v->match.sel, v->match.book_count, v->match.count);
+  v->totals_valid       = 1;
+  v->totals_value_epoch = book->value_epoch;
+  return &v->totals;
+}
+
+
+const ScreenOrder* screen_order(Screen *scr, const PositionBook *book) {
+  const ScreenMatch *m = screen_match(scr, book);
+  ScreenOrder       *o = &scr->order;
+
+  if (!o->valid || !sort_spec_eq(&o->spec, &scr->sort)) {
+    memcpy(o->rows, m->rows, sizeof(int) * (size_t)m->count);
+    o->count = m->count;
+    sort_rows(&scr->sort, book, o->rows, o->count);
+  } else {
+    int same_rows = memcmp(o->sel, m->sel, sizeof(o->sel)) == 0;
+    int ticked    = o->value_epoch != book->value_epoch && sort_uses_values(&scr->sort);
+    if (same_rows && !ticked) return o;
+
+    if (!same_rows) {
+      /* Survivors keep their place; newly matched rows go on the end */
+      int n = 0;
+      for (int k = 0; k < o->count; k++) {
+        if (sel_test(m->sel, o->rows[k])) o->rows[n++] = o->rows[k];
+      }
+      for (int k = 0; k < m->count; k++) {
+        if (!sel_test(o->sel, m->rows[k])) o->rows[n++] = m->rows[k];
+      }
+      o->count = n;
+    }
+    sort_repair(&scr->sort, book, o->rows, o->count);
+  }
+
+  o->spec        = scr->sort;
+  o->value_epoch = book->value_epoch;
+  o->gen++;
+  o->valid       = 1;
+  memcpy(o->sel, m->sel, sizeof(o->sel));
+  return o;
+}
+
+
+const ScreenGroups* screen_groups(Screen *scr, const PositionBook *book) {
+  const ScreenOrder *o = screen_order(scr, book);
+  ScreenGroups      *g = &scr->groups;
+
+  if (!g->valid || g->order_gen != o->gen || !group_spec_eq(&g->spec, &scr->group)) {
+    group_build(&g->set, &scr->group, book, o->rows, o->count);
+    g->spec      = scr->group;
+    g->order_gen = o->gen;
+    g->valid     = 1;
+    g->totals_gen++;
+  }
+  if (g->value_epoch != book->value_epoch) {
+    g->value_epoch = book->value_epoch;
+    g->totals_gen++;
+  }
+  return g;
+}
+
+
+const ViewTotals* screen_group_totals(Screen *scr, const PositionBook *book, int gi) {
+  ScreenGroups *g   = &scr->groups;
+  const Group  *grp = &g->set.groups[gi];
+  if (g->totals_at[gi] != g->totals_gen) {
+    totals_compute(&g->totals[gi], book, grp->sel, book->count, grp->count);
+    g->totals_at[gi] = g->totals_gen;
+  }
+  return &g->totals[gi];
+}
+
+
+void screen_mgr_refresh(ScreenManager *mgr, const PositionBook *book) {
+  for (int i = 0; i < mgr->count; i++) {
+    Screen *scr = &mgr->screens[i];
+    if (scr->active && (scr->kind == SCREEN_GRID || scr->kind == SCREEN_LADDER)) view_resolve(scr);
+  }
+  for (int v = 0; v < MAX_VIEWS; v++) {
+    if (s_views[v].used) view_update(&s_views[v], book, 0);
+  }
 }
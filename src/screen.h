@@ -20,23 +20,165 @@
 
 #include "bbg_tui.h"
 #include "data.h"
+#include "sel.h"
+#include "query.h"
+#include "sort.h"
+#include "group.h"
+#include "pivot.h"
+#include "ladder.h"
+#include "vega.h"
 
-#define MAX_SCREENS    8
+#define MAX_SCREENS    12                /* the demo opens 8; room for 4 more */
 #define SCREEN_NAME_LEN 32
 
 /* ---- Per-Screen Filter State ---- */
 typedef struct {
-  char  search[64];
+  char  search[64];     /* substring, or a query (query.h) */
   int   show_bonds;
   int   show_swaps;
   int   show_futures;
   int   show_swaptions;
 } ScreenFilter;
 
+/*
+** ---- Cached Filter Result ----
+** Rows passing the screen's filter, as a bitmap (for agg_*) and as an
+** ordered index list (for the grid). Matching depends only on static
+** position fields, so the cache is rebuilt only when the filter is edited
+** (filter_epoch) or rows are added (PositionBook.struct_epoch) — never on
+** price ticks (unless a query compares numeric fields: uses_values). An
+** edit that can only narrow the result (typing onto the query, unticking
+** an asset class) refines the cached rows instead of re-scanning the book,
+** and appended rows are verified on their own, keeping the rows before them.
+*/
+typedef struct {
+  uint64_t      sel[SEL_WORDS(MAX_POSITIONS)];
+  int           rows[MAX_POSITIONS];
+  int           count;
+  int           valid;                  /* 0 = never built */
+  ScreenFilter  built;                  /* filter (query lowercased) it reflects */
+  char          err[QRY_ERR_LEN];       /* query compile error, "" if none */
+  unsigned      filter_epoch;           /* ScreenView.uid it was built for */
+  unsigned      struct_epoch;           /* book->struct_epoch when built */
+  unsigned      value_epoch;            /* book->value_epoch when built */
+  int           book_count;             /* book->count when built */
+  int           uses_values;            /* query reads numeric columns */
+} ScreenMatch;
+
+/* ---- Outstanding rebuild on the filter worker (worker.h) ---- */
+typedef struct {
+  unsigned  gen;                        /* generation submitted */
+  unsigned  filter_epoch;               /* state it was submitted for */
+  unsigned  struct_epoch;
+  int       book_count;
+  int       pending;                    /* 1 = waiting on the worker */
+} ScreenRequest;
+
+/* ---- Footer aggregates of a view, shared by the screens showing it ---- */
+typedef struct {
+  int         count;
+  FxNotional  notional;
+  FxPnl       pnl;
+  FxPnl       pnl_day;
+  double      dv01;
+  double      cs01;
+  double      vega;
+  double      theta;
+} ViewTotals;
+
+/*
+** ---- Materialized View ----
+** One per distinct filter definition, however many screens show it: the
+** match and totals are computed once and every attached screen reads
+** them. Definitions are immutable — editing a screen's filter moves the
+** screen to the view for the new definition (found, or created seeded
+** with the old rows so narrowing edits still refine). Ad-hoc views are
+** dropped with their last screen; named views (screen_view_define) are
+** pinned and kept current even with no screen attached. At most
+** SCREEN_MAX_NAMED are pinned, so the other MAX_SCREENS slots are always
+** there for one manager's screens.
+*/
+#define SCREEN_MAX_NAMED 8
+#define MAX_VIEWS        (MAX_SCREENS + SCREEN_MAX_NAMED)
+
+typedef struct {
+  char          name[SCREEN_NAME_LEN];  /* "" = ad hoc */
+  unsigned      uid;                    /* worker owner; also the match's filter_epoch */
+  ScreenFilter  def;                    /* search lowercased */
+  ScreenMatch   match;
+  ScreenRequest req;
+  ViewTotals    totals;
+  int           totals_valid;           /* 0 after a new match lands */
+  unsigned      totals_value_epoch;     /* book->value_epoch of totals */
+  int           refs;                   /* screens attached */
+  int           pinned;                 /* named view */
+  int           used;
+} ScreenView;
+
+/*
+** ---- Screen's Row Order ----
+** The view's rows in the screen's sort order (per screen: screens sharing
+** a view may sort differently). A changed spec re-sorts; a changed match
+** keeps surviving rows in place and appends new ones; a price tick under
+** a numeric key only repairs (sort_repair) the few rows that moved.
+*/
+typedef struct {
+  int       rows[MAX_POSITIONS];
+  int       count;
+  uint64_t  sel[SEL_WORDS(MAX_POSITIONS)];  /* match rows it orders */
+  SortSpec  spec;                           /* spec it is sorted by */
+  unsigned  value_epoch;                    /* book->value_epoch sorted at */
+  unsigned  gen;                            /* bumped whenever rows may have changed */
+  int       valid;
+} ScreenOrder;
+
+/*
+** ---- Screen's Groups ----
+** The ordered rows bucketed by the screen's GroupSpec (hash grouping,
+** group.h). Regrouped only when the order or the spec changes. Subtotals
+** are computed lazily, per group, when its header is drawn, and cached
+** until the next price tick (totals_gen).
+*/
+typedef struct {
+  GroupSet    set;
+  ViewTotals  totals[GROUP_MAX];
+  unsigned    totals_at[GROUP_MAX];         /* totals_gen each was computed at */
+  unsigned    totals_gen;                   /* bumped on regroup / price tick */
+  GroupSpec   spec;                         /* spec it was grouped by */
+  unsigned    order_gen;                    /* ScreenOrder.gen grouped at */
+  unsigned    value_epoch;                  /* book->value_epoch of totals_gen */
+  int         valid;
+} ScreenGroups;
+
+/* ---- What a screen shows ---- */
+typedef enum {
+  SCREEN_GRID,                          /* filtered, sortable position grid */
+  SCREEN_MOVERS,                        /* top-N movers panels (movers.h) */
+  SCREEN_PIVOT,                         /* rows x columns cube (pivot.h) */
+  SCREEN_LADDER,                        /* DV01 ladders of the filtered rows (ladder.h) */
+  SCREEN_VEGA                           /* swaption expiry x tenor vega (vega.h) */
+} ScreenKind;
+
 /* ---- Single Screen ---- */
 typedef struct {
   char          name[SCREEN_NAME_LEN];  /* tab label: "POMS 1", "Bonds", etc */
+  unsigned      uid;                    /* stable id (survives reordering) */
+  ScreenKind    kind;
   ScreenFilter  filter;
+  unsigned      filter_epoch;           /* bumped on every filter edit */
+  int           view;                   /* attached view, -1 = none yet */
+  unsigned      view_epoch;             /* filter_epoch it was resolved at */
+  SortSpec      sort;                   /* header clicks; n = 0 → storage order */
+  ScreenOrder   order;
+  GroupSpec     group;                  /* n = 0 → flat grid */
+  ScreenGroups  groups;
+  GroupFolds    folds;                  /* collapsed groups */
+  PivotDef      pivot_def;              /* SCREEN_PIVOT axes */
+  PivotMeasure  pivot_measure;          /* measure on display */
+  BookPivot     pivot;
+  LadderSet     ladder;                 /* SCREEN_LADDER, grouped by group */
+  VegaLevel     vega_level;             /* SCREEN_VEGA: slice on display */
+  uint32_t      vega_key;
   int           selected_row;           /* -1 = none */
   int           active;                 /* is this slot in use? */
 } Screen;
@@ -72,6 +214,20 @@ int  screen_mgr_add(ScreenManager *mgr, const char *name);
 int  screen_mgr_add_preset(ScreenManager *mgr, const char *name,
                             int bonds, int swaps, int futures, int swaptions);
 
+/* ---- Add a top-N movers screen (no filter, no view) ---- */
+int  screen_mgr_add_movers(ScreenManager *mgr, const char *name);
+
+/* ---- Add a pivot screen over the whole book ---- */
+int  screen_mgr_add_pivot(ScreenManager *mgr, const char *name, const PivotDef *def,
+                          PivotMeasure measure);
+
+/* ---- Add a DV01 ladder screen with an asset class filter preset ---- */
+int  screen_mgr_add_ladder(ScreenManager *mgr, const char *name,
+                           int bonds, int swaps, int futures, int swaptions);
+
+/* ---- Add a swaption vega matrix screen (no filter, no view) ---- */
+int  screen_mgr_add_vega(ScreenManager *mgr, const char *name);
+
 /* ---- Remove screen at index (won't remove last screen) ---- */
 void screen_mgr_remove(ScreenManager *mgr, int idx);
 
@@ -81,8 +237,56 @@ Screen* screen_mgr_active(ScreenManager *mgr);
 /* ---- Render the tab bar. Returns 1 if active screen changed. ---- */
 int  screen_mgr_tab_bar(ScreenManager *mgr, mu_Context *ctx);
 
-/* ---- Check if a position passes the active screen's filter ---- */
-int  screen_filter_check(const ScreenFilter *f, const Position *p);
+/* ---- Invalidate the screen's match cache after a filter edit ---- */
+void screen_filter_touch(Screen *scr);
+
+/*
+** ---- Rows matching the screen's filter ----
+** Returns the cached result of the screen's view. When it's stale, a
+** rebuild is queued on the filter worker and the previous result is
+** returned (view req.pending = 1) until the new one lands; only the very
+** first build blocks.
+*/
+const ScreenMatch* screen_match(Screen *scr, const PositionBook *book);
+
+/* ---- The view the screen is attached to (resolved and updated as screen_match) ---- */
+const ScreenView* screen_view(Screen *scr, const PositionBook *book);
+
+/* ---- Footer aggregates of the screen's view, recomputed once per price tick ---- */
+const ViewTotals* screen_totals(Screen *scr, const PositionBook *book);
+
+/* ---- The screen's rows in display order (screen->sort) ---- */
+const ScreenOrder* screen_order(Screen *scr, const PositionBook *book);
+
+/* ---- The screen's ordered rows grouped by screen->group ---- */
+const ScreenGroups* screen_groups(Screen *scr, const PositionBook *book);
+
+/* ---- Subtotals of group gi of screen_groups(), computed on first use per tick ---- */
+const ViewTotals* screen_group_totals(Screen *scr, const PositionBook *book, int gi);
+
+/* ---- Define (or name) a pinned view. Returns 0, or -1 once SCREEN_MAX_NAMED are pinned. ---- */
+int  screen_view_define(const char *name, const ScreenFilter *f);
+
+/*
+** ---- Keep every view current ----
+** Call once per frame. Each distinct view (not each screen) that is stale
+** is submitted to the worker pool (evaluated in parallel, one view per
+** thread) and finished results are collected without blocking, so
+** switching tabs finds the result ready. Only filter matching goes to the
+** pool: row order (screen_order) and totals (screen_totals,
+** screen_group_totals) stay on the UI thread, computed lazily for the
+** screen being drawn — a tick repairs a few rows and re-runs a handful
+** of agg passes, less than a book snapshot for a job would cost.
+*/
+void screen_mgr_refresh(ScreenManager *mgr, const PositionBook *book);
+
+/*
+** ---- Rebuild m for filter f over book (worker thread) ----
+** m holds the previous result on entry (refined in place when possible).
+** ix and q are the caller's index and query scratch.
+*/
+void screen_match_build(ScreenMatch *m, const ScreenFilter *f, unsigned filter_epoch,
+                        const PositionBook *book, TrigramIndex *ix, Query *q);
 
 /* ---- Swap two screens (for drag-and-drop reordering) ---- */
 void screen_mgr_swap(ScreenManager *mgr, int a, int b);
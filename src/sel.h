@@ -0,0 +1,68 @@
+/*
+** sel.h — Dense Selection Bitmaps
+**
+** One bit per book row, 64 rows per word. Bit i of word i/64 set means
+** row i is selected. Bits past the row count are always kept clear so
+** word-wide ops (popcount, AND/OR) need no tail handling.
+**
+** This is the selection representation everywhere: filter criteria each
+** produce (or keep precomputed) a bitmap and are composed with the word
+** ops below, which the compiler vectorizes. At MAX_POSITIONS rows a dense
+** bitmap is a couple of words, so no compressed container is needed.
+*/
+
+#ifndef SEL_H
+#define SEL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define SEL_WORDS(n)  (((n) + 63) / 64)
+
+static inline void sel_clear(uint64_t *sel, int n) {
+  memset(sel, 0, sizeof(uint64_t) * (size_t)SEL_WORDS(n));
+}
+
+/* Select rows [0, n) — tail bits of the last word stay clear */
+static inline void sel_fill(uint64_t *sel, int n) {
+  int w = SEL_WORDS(n);
+  for (int i = 0; i < w; i++) sel[i] = ~0ull;
+  if (n & 63) sel[w - 1] = (1ull << (n & 63)) - 1;
+}
+
+static inline void sel_set(uint64_t *sel, int i) {
+  sel[i >> 6] |= 1ull << (i & 63);
+}
+
+static inline void sel_reset(uint64_t *sel, int i) {
+  sel[i >> 6] &= ~(1ull << (i & 63));
+}
+
+static inline int sel_test(const uint64_t *sel, int i) {
+  return (int)((sel[i >> 6] >> (i & 63)) & 1u);
+}
+
+/* ---- Word-wise composition: dst = a OP b over rows [0, n) ---- */
+static inline void sel_and(uint64_t *dst, const uint64_t *a, const uint64_t *b, int n) {
+  for (int i = 0, w = SEL_WORDS(n); i < w; i++) dst[i] = a[i] & b[i];
+}
+
+static inline void sel_or(uint64_t *dst, const uint64_t *a, const uint64_t *b, int n) {
+  for (int i = 0, w = SEL_WORDS(n); i < w; i++) dst[i] = a[i] | b[i];
+}
+
+static inline void sel_andnot(uint64_t *dst, const uint64_t *a, const uint64_t *b, int n) {
+  for (int i = 0, w = SEL_WORDS(n); i < w; i++) dst[i] = a[i] & ~b[i];
+}
+
+static inline void sel_copy(uint64_t *dst, const uint64_t *a, int n) {
+  memcpy(dst, a, sizeof(uint64_t) * (size_t)SEL_WORDS(n));
+}
+
+static inline int sel_count(const uint64_t *sel, int n) {
+  int c = 0, w = SEL_WORDS(n);
+  for (int i = 0; i < w; i++) c += __builtin_popcountll(sel[i]);
+  return c;
+}
+
+#endif
@@ -0,0 +1,399 @@
+/*
+** sort.c — Grid Row Ordering (radix sort + incremental repair)
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <string.h>
+#include "sort.h"
+
+/* Fall back to a full sort past one descent per this many rows */
+#define SORT_REPAIR_DIV 8
+
+#define RADIX_BITS    8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES  (64 / RADIX_BITS)
+
+void sort_click(SortSpec *s, int col, int shift) {
+  int at = sort_key_index(s, col);
+
+  if (!shift) {
+    int desc = (at == 0 && s->n == 1) ? !s->keys[0].desc : 0;
+    s->keys[0] = (SortKey){ (uint8_t)col, (uint8_t)desc };
+    s->n = 1;
+    return;
+  }
+
+  if (at >= 0) {
+    s->keys[at].desc = (uint8_t)!s->keys[at].desc;
+    return;
+  }
+  if (s->n == SORT_MAX_KEYS) s->n--;
+  s->keys[s->n++] = (SortKey){ (uint8_t)col, 0 };
+}
+
+
+int sort_spec_eq(const SortSpec *a, const SortSpec *b) {
+  if (a->n != b->n) return 0;
+  for (int k = 0; k < a->n; k++) {
+    if (a->keys[k].col != b->keys[k].col || a->keys[k].desc != b->keys[k].desc) return 0;
+  }
+  return 1;
+}
+
+
+int sort_uses_values(const SortSpec *s) {
+  for (int k = 0; k < s->n; k++) {
+    if (s->keys[k].col < FIELD_COUNT) return 1;
+  }
+  return 0;
+}
+
+
+int sort_key_index(const SortSpec *s, int col) {
+  for (int k = 0; k < s->n; k++) {
+    if (s->keys[k].col == col) return k;
+  }
+  return -1;
+}
+
+
+/* ============================================================================
+**  Comparison
+** ============================================================================*/
+
+static const char *text_of(const Position *p, int col) {
+  switch (col) {
+    case SORT_INSTRUMENT: return p->instrument;
+    case SORT_CUSIP:      return p->cusip;
+    case SORT_BOOK:       return data_book_short(p->book);
+    default:              return data_desk_short(p->desk);
+  }
+}
+
+/* <0, 0, >0 as row x sorts before, with, after row y; 0 only if x == y */
+static int cmp_rows(const SortSpec *s, const PositionBook *book, int x, int y) {
+  for (int k = 0; k < s->n; k++) {
+    int col = s->keys[k].col, c;
+    if (col < FIELD_COUNT) {
+      double a = book->cols.f64[col][x], b = book->cols.f64[col][y];
+      c = (a > b) - (a < b);
+    } else {
+      c = strcmp(text_of(&book->items[x], col), text_of(&book->items[y], col));
+    }
+    if (c) return s->keys[k].desc ? -c : c;
+  }
+  return (x > y) - (x < y);
+}
+
+
+/* Bottom-up merge sort by cmp_rows, ping-ponging between rows and tmp */
+static void merge_sort(const SortSpec *s, const PositionBook *book, int *rows, int n) {
+  int  tmp[MAX_POSITIONS];
+  int *src = rows, *dst = tmp;
+  for (int w = 1; w < n; w *= 2) {
+    for (int lo = 0; lo < n; lo += 2 * w) {
+      int mid = (lo + w < n) ? lo + w : n;
+      int hi  = (lo + 2 * w < n) ? lo + 2 * w : n;
+      int i = lo, j = mid, o = lo;
+      while (i < mid && j < hi) {
+        dst[o++] = (cmp_rows(s, book, src[j], src[i]) < 0) ? src[j++] : src[i++];
+      }
+      while (i < mid) dst[o++] = src[i++];
+      while (j < hi)  dst[o++] = src[j++];
+    }
+    int *t = src; src = dst; dst = t;
+  }
+  if (src != rows) memcpy(rows, src, sizeof(int) * (size_t)n);
+}
+
+
+/* ============================================================================
+**  Radix Engine
+** ============================================================================*/
+
+uint64_t sort_key_f64(double v) {
+  uint64_t u;
+  if (v == 0) v = 0;                /* -0.0 sorts with +0.0, as in cmp_rows */
+  memcpy(&u, &v, sizeof(u));
+  return (u >> 63) ? ~u : u | (UINT64_C(1) << 63);
+}
+
+
+/* State shared by the threads of one sort_radix() call */
+typedef struct {
+  SortPair          *a, *tmp;
+  size_t             n;
+  int                nt;            /* threads actually running */
+  int                skip;          /* current pass has one digit only */
+  size_t             hist[SORT_MAX_THREADS][RADIX_BUCKETS];
+  pthread_barrier_t  bar;
+  pthread_mutex_t    mu;
+  pthread_cond_t     go_cv;
+  int                go;
+} RadixShared;
+
+typedef struct {
+  RadixShared *sh;
+  int          t;
+} RadixJob;
+
+/* One call at a time: the grid sorts on the UI thread only */
+static RadixShared s_radix = {
+  .mu    = PTHREAD_MUTEX_INITIALIZER,
+  .go_cv = PTHREAD_COND_INITIALIZER,
+};
+
+static void radix_sync(RadixShared *sh) {
+  if (sh->nt > 1) pthread_barrier_wait(&sh->bar);
+}
+
+/*
+** Thread t's share of the sort: per pass, count digits over its chunk;
+** thread 0 turns all counts into output offsets (digit-major, then
+** thread order, so equal digits keep input order); then every thread
+** scatters its chunk. A pass where every key has the same digit is
+** skipped — doubles of similar magnitude share their top bytes, small
+** ranks their high bytes.
+*/
+static void radix_run(RadixShared *sh, int t) {
+  int       nt = sh->nt;
+  size_t    lo = sh->n * (size_t)t / (size_t)nt;
+  size_t    hi = sh->n * (size_t)(t + 1) / (size_t)nt;
+  size_t   *h  = sh->hist[t];
+  SortPair *src = sh->a, *dst = sh->tmp;
+
+  for (int p = 0; p < RADIX_PASSES; p++) {
+    int shift = p * RADIX_BITS;
+    memset(h, 0, sizeof(sh->hist[t]));
+    for (size_t i = lo; i < hi; i++) h[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++;
+    radix_sync(sh);
+
+    if (t == 0) {
+      size_t at = 0;
+      sh->skip = 0;
+      for (int d = 0; d < RADIX_BUCKETS; d++) {
+        size_t total = 0;
+        for (int u = 0; u < nt; u++) {
+          size_t c = sh->hist[u][d];
+          sh->hist[u][d] = at;
+          at    += c;
+          total += c;
+        }
+        if (total == sh->n) sh->skip = 1;
+      }
+    }
+    radix_sync(sh);
+
+    if (!sh->skip) {
+      for (size_t i = lo; i < hi; i++) {
+        dst[h[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+      }
+      SortPair *x = src; src = dst; dst = x;
+    }
+    radix_sync(sh);
+  }
+
+  if (src != sh->a) memcpy(sh->a + lo, src + lo, sizeof(SortPair) * (hi - lo));
+}
+
+static void *radix_main(void *arg) {
+  RadixJob    *job = arg;
+  RadixShared *sh  = job->sh;
+
+  pthread_mutex_lock(&sh->mu);
+  while (!sh->go) pthread_cond_wait(&sh->go_cv, &sh->mu);
+  pthread_mutex_unlock(&sh->mu);
+
+  radix_run(sh, job->t);
+  return NULL;
+}
+
+
+void sort_radix(SortPair *a, SortPair *tmp, size_t n, int threads) {
+  if (n < 2) return;
+  if (threads > SORT_MAX_THREADS) threads = SORT_MAX_THREADS;
+  if (threads < 1 || n < SORT_PAR_MIN) threads = 1;
+
+  RadixShared *sh = &s_radix;
+  sh->a   = a;
+  sh->tmp = tmp;
+  sh->n   = n;
+  sh->nt  = 1;
+  if (threads == 1) {
+    radix_run(sh, 0);
+    return;
+  }
+
+  /* Workers wait at the gate until we know how many actually started */
+  pthread_t th[SORT_MAX_THREADS];
+  RadixJob  job[SORT_MAX_THREADS];
+  int       started = 1;
+  sh->go = 0;
+  for (; started < threads; started++) {
+    job[started] = (RadixJob){ sh, started };
+    if (pthread_create(&th[started], NULL, radix_main, &job[started]) != 0) break;
+  }
+
+  sh->nt = started;
+  if (started > 1) pthread_barrier_init(&sh->bar, NULL, (unsigned)started);
+  pthread_mutex_lock(&sh->mu);
+  sh->go = 1;
+  pthread_cond_broadcast(&sh->go_cv);
+  pthread_mutex_unlock(&sh->mu);
+
+  radix_run(sh, 0);
+  for (int t = 1; t < started; t++) pthread_join(th[t], NULL);
+  if (started > 1) pthread_barrier_destroy(&sh->bar);
+}
+
+
+/* ============================================================================
+**  Text Collation Ranks
+** ============================================================================*/
+
+/*
+** Rank of each row's text per text column (equal strings, equal rank),
+** so text keys radix-sort as small integers. Book and desk rank their
+** interned ids; instrument and CUSIP rank rows. Names never change, so
+** the ranks only go stale when rows are added.
+*/
+static struct {
+  const PositionBook *book;
+  unsigned            struct_epoch;
+  int                 count;
+  uint32_t            rank[SORT_COL_COUNT - SORT_INSTRUMENT][MAX_POSITIONS];
+} s_ranks;
+
+/* Rank ids[0, n) (sorted by text) into rank[], sharing ranks between equals */
+static void assign_ranks(uint32_t *rank, const int *ids, int n,
+                         const char *(*text)(const PositionBook *, int),
+                         const PositionBook *book)
+{
+  uint32_t r = 0;
+  for (int i = 0; i < n; i++) {
+    if (i && strcmp(text(book, ids[i - 1]), text(book, ids[i])) != 0) r++;
+    rank[ids[i]] = r;
+  }
+}
+
+static const char *row_instrument(const PositionBook *b, int i) { return b->items[i].instrument; }
+static const char *row_cusip(const PositionBook *b, int i)      { return b->items[i].cusip; }
+static const char *book_name(const PositionBook *b, int i)      { return data_book_short(b->books.names[i]); }
+static const char *desk_name(const PositionBook *b, int i)      { return data_desk_short(b->desks.names[i]); }
+
+/* Insertion sort of dictionary ids by display text; dictionaries are tiny */
+static void sort_names(int *ids, int n, const char *(*text)(const PositionBook *, int),
+                       const PositionBook *book)
+{
+  for (int i = 0; i < n; i++) ids[i] = i;
+  for (int i = 1; i < n; i++) {
+    int id = ids[i], j = i;
+    while (j > 0 && strcmp(text(book, ids[j - 1]), text(book, id)) > 0) {
+      ids[j] = ids[j - 1];
+      j--;
+    }
+    ids[j] = id;
+  }
+}
+
+static void ranks_sync(const PositionBook *book) {
+  if (s_ranks.book == book && s_ranks.struct_epoch == book->struct_epoch &&
+      s_ranks.count == book->count) return;
+
+  int ids[MAX_POSITIONS];
+  for (int col = SORT_INSTRUMENT; col <= SORT_CUSIP; col++) {
+    SortSpec by = { { { (uint8_t)col, 0 } }, 1 };
+    for (int i = 0; i < book->count; i++) ids[i] = i;
+    merge_sort(&by, book, ids, book->count);
+    assign_ranks(s_ranks.rank[col - SORT_INSTRUMENT], ids, book->count,
+                 col == SORT_INSTRUMENT ? row_instrument : row_cusip, book);
+  }
+  sort_names(ids, book->books.count, book_name, book);
+  assign_ranks(s_ranks.rank[SORT_BOOK - SORT_INSTRUMENT], ids, book->books.count, book_name, book);
+  sort_names(ids, book->desks.count, desk_name, book);
+  assign_ranks(s_ranks.rank[SORT_DESK - SORT_INSTRUMENT], ids, book->desks.count, desk_name, book);
+
+  s_ranks.book         = book;
+  s_ranks.struct_epoch = book->struct_epoch;
+  s_ranks.count        = book->count;
+}
+
+static uint64_t row_key(const PositionBook *book, SortKey k, int row) {
+  uint64_t v;
+  switch (k.col) {
+    case SORT_INSTRUMENT:
+    case SORT_CUSIP: v = s_ranks.rank[k.col - SORT_INSTRUMENT][row];                 break;
+    case SORT_BOOK:  v = s_ranks.rank[SORT_BOOK - SORT_INSTRUMENT][book->cols.book[row]]; break;
+    case SORT_DESK:  v = s_ranks.rank[SORT_DESK - SORT_INSTRUMENT][book->cols.desk[row]]; break;
+    default:         v = sort_key_f64(book->cols.f64[k.col][row]);                  break;
+  }
+  return k.desc ? ~v : v;
+}
+
+
+/* ============================================================================
+**  Full Sort
+** ============================================================================*/
+
+void sort_rows(const SortSpec *s, const PositionBook *book, int *rows, int n) {
+  if (n < 2) return;
+  static SortPair pairs[MAX_POSITIONS], tmp[MAX_POSITIONS];
+
+  for (int k = 0; k < s->n; k++) {
+    if (s->keys[k].col >= SORT_INSTRUMENT) {
+      ranks_sync(book);
+      break;
+    }
+  }
+
+  /* Radix passes are stable, so sorting by the row index first and then
+     by each key, least significant first, yields the full order */
+  int ascending = 1;
+  for (int i = 0; i < n; i++) {
+    pairs[i] = (SortPair){ (uint64_t)rows[i], (uint32_t)rows[i] };
+    ascending &= (i == 0 || rows[i - 1] < rows[i]);
+  }
+  if (!ascending) sort_radix(pairs, tmp, (size_t)n, 1);
+
+  for (int k = s->n - 1; k >= 0; k--) {
+    for (int i = 0; i < n; i++) pairs[i].key = row_key(book, s->keys[k], (int)pairs[i].row);
+    sort_radix(pairs, tmp, (size_t)n, 1);
+  }
+  for (int i = 0; i < n; i++) rows[i] = (int)pairs[i].row;
+}
+
+
+/* ============================================================================
+**  Incremental Repair
+** ============================================================================*/
+
+int sort_repair(const SortSpec *s, const PositionBook *book, int *rows, int n) {
+  int descents = 0;
+  for (int i = 1; i < n; i++) {
+    descents += cmp_rows(s, book, rows[i - 1], rows[i]) > 0;
+  }
+  if (!descents) return 0;
+  if (descents * SORT_REPAIR_DIV > n) {
+    sort_rows(s, book, rows, n);
+    return n;
+  }
+
+  /* Binary insertion: rows[0, i) is sorted; place rows[i] if out of order */
+  int moved = 0;
+  for (int i = 1; i < n; i++) {
+    int r = rows[i];
+    if (cmp_rows(s, book, rows[i - 1], r) < 0) continue;
+    int lo = 0, hi = i - 1;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (cmp_rows(s, book, rows[mid], r) < 0) lo = mid + 1;
+      else                                    hi = mid;
+    }
+    memmove(&rows[lo + 1], &rows[lo], sizeof(int) * (size_t)(i - lo));
+    rows[lo] = r;
+    moved++;
+  }
+  return moved;
+}
@@ -0,0 +1,92 @@
+/*
+** sort.h — Grid Row Ordering
+**
+** A SortSpec is up to SORT_MAX_KEYS (column, direction) pairs, most
+** significant first. Numeric keys read BookColumns; text keys compare the
+** strings the grid shows (book/desk by short code). Ties after the last
+** key fall back to row index, so the order is total: any correct sort
+** produces the same sequence, and equal rows keep storage order.
+**
+** sort_rows() is a full LSD radix sort: numeric keys become
+** order-preserving uint64s (sort_key_f64), text keys precomputed
+** collation ranks, and each key is one stable radix sort over (key, row)
+** pairs, least significant key first, so there is no comparison callback
+** at all. sort_radix() is the engine on its own, threaded for large
+** inputs.
+**
+** sort_repair() restores the order of rows that were sorted before a tick
+** moved some values: it counts descents and, when only a few rows moved,
+** re-inserts each out-of-place row by binary search (O(n + moved * log n)
+** compares) instead of re-sorting everything.
+*/
+
+#ifndef SORT_H
+#define SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "data.h"
+
+#define SORT_MAX_KEYS    3
+#define SORT_MAX_THREADS 8
+#define SORT_PAR_MIN     (1 << 16)  /* sort_radix() stays serial below this */
+
+/* Sort columns: every NumField, then the text columns */
+typedef enum {
+  SORT_INSTRUMENT = FIELD_COUNT,
+  SORT_CUSIP,
+  SORT_BOOK,
+  SORT_DESK,
+  SORT_COL_COUNT
+} SortCol;
+
+typedef struct {
+  uint8_t  col;                     /* NumField or SortCol */
+  uint8_t  desc;                    /* 1 = descending */
+} SortKey;
+
+typedef struct {
+  SortKey  keys[SORT_MAX_KEYS];
+  int      n;                       /* 0 = storage order */
+} SortSpec;
+
+/* One element of a radix sort */
+typedef struct {
+  uint64_t key;
+  uint32_t row;
+} SortPair;
+
+/*
+** ---- Header click ----
+** Plain click: sort by col alone, or flip its direction if it already is
+** the only key. Shift-click: flip col if it's a key, else append it as
+** the least significant key (dropping the last if full).
+*/
+void sort_click(SortSpec *s, int col, int shift);
+
+/* ---- 1 if the specs are the same ---- */
+int  sort_spec_eq(const SortSpec *a, const SortSpec *b);
+
+/* ---- 1 if any key reads a live (numeric) column ---- */
+int  sort_uses_values(const SortSpec *s);
+
+/* ---- Position of col in s (0 = primary), or -1 ---- */
+int  sort_key_index(const SortSpec *s, int col);
+
+/* ---- uint64 that orders like v (-0.0 == +0.0) ---- */
+uint64_t sort_key_f64(double v);
+
+/*
+** ---- Stable sort of a[0, n) by key ----
+** tmp holds n pairs of scratch. Uses up to threads threads (including
+** the caller) once n >= SORT_PAR_MIN. Not reentrant.
+*/
+void sort_radix(SortPair *a, SortPair *tmp, size_t n, int threads);
+
+/* ---- Full stable sort of rows[0, n) ---- */
+void sort_rows(const SortSpec *s, const PositionBook *book, int *rows, int n);
+
+/* ---- Re-sort nearly sorted rows[0, n). Returns the number of rows moved. ---- */
+int  sort_repair(const SortSpec *s, const PositionBook *book, int *rows, int n);
+
+#endif
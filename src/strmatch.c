@@ -0,0 +1,120 @@
+/*
+** strmatch.c — Case-Insensitive Substring Matching (AVX2 + scalar)
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "strmatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SM_X86 1
+#include <immintrin.h>
+#else
+#define SM_X86 0
+#endif
+
+static inline char lower(char c) {
+  return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+int sm_lower(char *dst, int cap, const char *src) {
+  if (cap <= 0) return 0;
+  int n = 0;
+  while (src[n] && n < cap - 1) {
+    dst[n] = lower(src[n]);
+    n++;
+  }
+  dst[n] = '\0';
+  return n;
+}
+
+
+/* ============================================================================
+**  Scalar Path
+** ============================================================================*/
+
+static int find_scalar(const char *hay, int hlen, const char *nd, int nlen) {
+  const char *p   = hay;
+  const char *end = hay + hlen - nlen + 1;   /* last valid start + 1 */
+  while (p < end) {
+    p = memchr(p, nd[0], (size_t)(end - p));
+    if (!p) return 0;
+    if (p[nlen - 1] == nd[nlen - 1] && memcmp(p + 1, nd + 1, (size_t)(nlen - 1)) == 0)
+      return 1;
+    p++;
+  }
+  return 0;
+}
+
+
+/* ============================================================================
+**  AVX2 Path — first/last byte filter over 32 start positions per step
+** ============================================================================*/
+
+#if SM_X86
+
+__attribute__((target("avx2")))
+static int find_avx2(const char *hay, int hlen, const char *nd, int nlen) {
+  const __m256i first = _mm256_set1_epi8(nd[0]);
+  const __m256i last  = _mm256_set1_epi8(nd[nlen - 1]);
+  int starts = hlen - nlen + 1;
+
+  for (int i = 0; i < starts; i += 32) {
+    __m256i bf = _mm256_loadu_si256((const __m256i *)(const void *)(hay + i));
+    __m256i bl = _mm256_loadu_si256((const __m256i *)(const void *)(hay + i + nlen - 1));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, bf), _mm256_cmpeq_epi8(last, bl)));
+
+    /* Drop start positions past the end (they read padding) */
+    if (starts - i < 32) mask &= (1u << (starts - i)) - 1;
+
+    while (mask) {
+      int j = __builtin_ctz(mask);
+      if (nlen <= 2 || memcmp(hay + i + j + 1, nd + 1, (size_t)(nlen - 2)) == 0)
+        return 1;
+      mask &= mask - 1;
+    }
+  }
+  return 0;
+}
+
+#endif
+
+
+/* ============================================================================
+**  Public Entry Points
+** ============================================================================*/
+
+int sm_simd_active(void) {
+#if SM_X86
+  return __builtin_cpu_supports("avx2");
+#else
+  return 0;
+#endif
+}
+
+
+int sm_find(const char *hay, int hlen, const char *needle, int nlen) {
+  if (nlen <= 0) return 1;
+  if (nlen > hlen) return 0;
+#if SM_X86
+  if (sm_simd_active()) return find_avx2(hay, hlen, needle, nlen);
+#endif
+  return find_scalar(hay, hlen, needle, nlen);
+}
+
+
+int sm_contains_ci(const char *hay, const char *needle) {
+  char nd[64];
+  int nlen = sm_lower(nd, (int)sizeof(nd), needle);
+  if (!nlen) return 1;
+
+  for (const char *p = hay; *p; p++) {
+    if (lower(*p) != nd[0]) continue;
+    int j = 1;
+    while (j < nlen && p[j] && lower(p[j]) == nd[j]) j++;
+    if (j == nlen) return 1;
+    if (!p[j]) return 0;              /* hay ran out before the needle */
+  }
+  return 0;
+}
@@ -0,0 +1,31 @@
+/*
+** strmatch.h — Case-Insensitive Substring Matching
+**
+** The filter box matches against instrument/cusip/book/desk text. The hot
+** path lowercases each haystack once (at index time) and the needle once
+** per query, then sm_find() compares raw bytes: on x86 an AVX2 kernel
+** tests 32 candidate positions per step on the needle's first and last
+** byte and only memcmp()s the survivors; elsewhere a scalar memchr loop.
+**
+** sm_find() may read up to SM_PAD bytes past hay[hlen], so haystacks
+** must live in buffers padded accordingly (see TrigramIndex.hay).
+*/
+
+#ifndef STRMATCH_H
+#define STRMATCH_H
+
+#define SM_PAD 32
+
+/* ---- ASCII-lowercase src into dst (NUL-terminated, truncated). Returns length. ---- */
+int sm_lower(char *dst, int cap, const char *src);
+
+/* ---- 1 if lowercased needle occurs in lowercased, SM_PAD-padded hay ---- */
+int sm_find(const char *hay, int hlen, const char *needle, int nlen);
+
+/* ---- Unpadded fallback: case-insensitive strstr on raw strings ---- */
+int sm_contains_ci(const char *hay, const char *needle);
+
+/* ---- 1 if the AVX2 kernel is in use ---- */
+int sm_simd_active(void);
+
+#endif
@@ -10,6 +10,8 @@
 #define TABLE_H
 
 #include "bbg_tui.h"
+#include "fixed.h"
+#include "cellcache.h"
 
 /* ---- Draw a text cell with explicit foreground color ---- */
 void tbl_cell_text(mu_Context *ctx, const char *text, mu_Color fg, int opt);
@@ -17,12 +19,20 @@ void tbl_cell_text(mu_Context *ctx, const char *text, mu_Color fg, int opt);
 /* ---- Draw a text cell with background + foreground ---- */
 void tbl_cell(mu_Context *ctx, const char *text, mu_Color bg, mu_Color fg, int opt);
 
+/* ---- Draw a cached cell: its string as is, its width measured once ---- */
+void tbl_cell_cached(mu_Context *ctx, CellEntry *e, mu_Color bg, mu_Color fg, int opt);
+
 /* ---- Draw a numeric cell, right-aligned, with auto P&L coloring ---- */
-void tbl_cell_pnl(mu_Context *ctx, double val, const char *fmt,
-                   mu_Color bg);
+/* (decimals / flags as fmt_f64: FMT_PLUS, FMT_COMMA, FMT_K, FMT_MM) */
+void tbl_cell_pnl(mu_Context *ctx, double val, int decimals, int flags,
+                  mu_Color bg);
+
+/* ---- P&L cell straight from book storage (exact in BBG_FIXED builds) ---- */
+void tbl_cell_fxpnl(mu_Context *ctx, FxPnl val, int decimals, int flags,
+                    mu_Color bg);
 
 /* ---- Draw a numeric cell, right-aligned, specified color ---- */
-void tbl_cell_num(mu_Context *ctx, double val, const char *fmt,
+void tbl_cell_num(mu_Context *ctx, double val, int decimals, int flags,
                   mu_Color bg, mu_Color fg);
 
 /* ---- Draw an empty cell with background ---- */
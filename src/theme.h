@@ -80,4 +80,15 @@ static inline mu_Color th_pnl_color(double val) {
        :                  TH_PNL_ZERO;
 }
 
+/* Heat-map cell background: row colour shaded toward green (x > 0) or
+   red (x < 0) by |x| / scale */
+static inline mu_Color th_heat(double x, double scale) {
+  double t = (scale > 0) ? (x < 0 ? -x : x) / scale : 0;
+  if (t > 1) t = 1;
+  mu_Color base = TH_ROW_EVEN;
+  mu_Color hot  = (x < 0) ? mu_color(150, 30, 30, 255) : mu_color(30, 130, 50, 255);
+  return mu_color(base.r + (int)((hot.r - base.r) * t), base.g + (int)((hot.g - base.g) * t),
+                  base.b + (int)((hot.b - base.b) * t), 255);
+}
+
 #endif
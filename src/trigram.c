@@ -0,0 +1,104 @@
+/*
+** trigram.c — Trigram Search Index
+*/
+
+#include <string.h>
+#include "trigram.h"
+
+static inline unsigned char lower(unsigned char c) {
+  return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + 32) : c;
+}
+
+/* Fibonacci hash of the 24-bit trigram code into a bucket */
+static inline unsigned tri_bucket(unsigned char a, unsigned char b, unsigned char c) {
+  uint32_t code = (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16);
+  return (code * 2654435761u) >> (32 - TRI_BUCKET_BITS);
+}
+
+static void index_text(TrigramIndex *ix, int row, const char *text) {
+  if (!text) return;
+  const unsigned char *s = (const unsigned char *)text;
+  if (!s[0] || !s[1]) return;
+
+  unsigned char a = lower(s[0]), b = lower(s[1]);
+  for (int i = 2; s[i]; i++) {
+    unsigned char c = lower(s[i]);
+    sel_set(ix->post[tri_bucket(a, b, c)], row);
+    a = b;
+    b = c;
+  }
+}
+
+
+/* Append lowercased text to row's haystack, leaving SM_PAD zero bytes;
+   flag the row if it doesn't all fit */
+static void append_hay(TrigramIndex *ix, int row, const char *text) {
+  char *hay = ix->hay[row];
+  int   len = ix->hay_len[row];
+  int   cap = TRI_HAY_CAP - SM_PAD;
+  if (!text || !text[0]) return;
+  if (len >= cap - 1) {
+    sel_set(ix->long_text, row);
+    return;
+  }
+  if (len > 0) hay[len++] = TRI_FIELD_SEP;
+  int n = sm_lower(hay + len, cap - len, text);
+  if (text[n]) sel_set(ix->long_text, row);
+  ix->hay_len[row] = len + n;
+}
+
+
+void tri_init(TrigramIndex *ix) {
+  memset(ix, 0, sizeof(*ix));
+}
+
+
+void tri_sync(TrigramIndex *ix, const PositionBook *book) {
+  if (ix->book != book) tri_init(ix);
+  ix->book = book;
+
+  for (int i = ix->count; i < book->count; i++) {
+    const Position *p = &book->items[i];
+    const char *fields[4] = { p->instrument, p->cusip, p->book, p->desk };
+    for (int f = 0; f < 4; f++) {
+      index_text(ix, i, fields[f]);
+      append_hay(ix, i, fields[f]);
+    }
+  }
+  ix->count = book->count;
+}
+
+
+int tri_candidates(const TrigramIndex *ix, const char *needle, uint64_t *out) {
+  const unsigned char *s = (const unsigned char *)needle;
+  if (!s[0] || !s[1] || !s[2]) return 0;
+
+  int words = SEL_WORDS(ix->count);
+  sel_fill(out, ix->count);
+
+  unsigned char a = lower(s[0]), b = lower(s[1]);
+  for (int i = 2; s[i]; i++) {
+    unsigned char c = lower(s[i]);
+    const uint64_t *post = ix->post[tri_bucket(a, b, c)];
+    uint64_t any = 0;
+    for (int k = 0; k < words; k++) any |= (out[k] &= post[k]);
+    if (!any) break;                  /* nothing left to narrow */
+    a = b;
+    b = c;
+  }
+  return 1;
+}
+
+
+int tri_row_match(const TrigramIndex *ix, int row, const char *needle, int nlen) {
+  if (!sel_test(ix->long_text, row)) return sm_find(ix->hay[row], ix->hay_len[row], needle, nlen);
+
+  /* Truncated haystack: scalar match on each field (the separator keeps
+     a needle from spanning two fields either way) */
+  const Position *p = &ix->book->items[row];
+  const char *fields[4] = { p->instrument, p->cusip, p->book, p->desk };
+  for (int f = 0; f < 4; f++) {
+    if (fields[f] && sm_contains_ci(fields[f], needle)) return 1;
+  }
+  return 0;
+}
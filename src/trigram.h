@@ -0,0 +1,60 @@
+/*
+** trigram.h — Trigram Search Index
+**
+** Inverted index from lowercased 3-byte substrings of each row's text
+** fields (instrument, cusip, book, desk) to the rows containing them.
+** A substring query of length >= 3 is answered by AND-ing the posting
+** bitmaps of its trigrams; the result is a superset of the true matches
+** (trigrams are hashed into buckets, and adjacency is not checked), so
+** callers verify the surviving candidates with the exact matcher.
+**
+** Rows are only ever appended to a PositionBook and their text fields
+** never change, so tri_sync() indexes just the rows added since the last
+** call. Postings are dense bitmaps (sel.h), the natural representation
+** at MAX_POSITIONS rows.
+**
+** For verification each row also keeps its text fields lowercased and
+** joined by TRI_FIELD_SEP in a zero-padded buffer, ready for sm_find().
+** Text too long for the buffer is flagged, and tri_row_match() checks
+** such a row against its raw fields instead.
+*/
+
+#ifndef TRIGRAM_H
+#define TRIGRAM_H
+
+#include <stdint.h>
+#include "data.h"
+#include "sel.h"
+#include "strmatch.h"
+
+#define TRI_BUCKET_BITS 12
+#define TRI_BUCKETS     (1 << TRI_BUCKET_BITS)
+#define TRI_HAY_CAP     128             /* text + NUL + SM_PAD padding */
+#define TRI_FIELD_SEP   '\x1f'          /* never typed, so never matched */
+
+typedef struct {
+  uint64_t            post[TRI_BUCKETS][SEL_WORDS(MAX_POSITIONS)];
+  char                hay[MAX_POSITIONS][TRI_HAY_CAP];
+  int                 hay_len[MAX_POSITIONS];
+  uint64_t            long_text[SEL_WORDS(MAX_POSITIONS)];  /* hay truncated */
+  const PositionBook *book;         /* book the postings describe */
+  int                 count;        /* rows indexed so far */
+} TrigramIndex;
+
+/* ---- Start empty (first tri_sync indexes the whole book) ---- */
+void tri_init(TrigramIndex *ix);
+
+/* ---- Index rows added to book since the last sync ---- */
+void tri_sync(TrigramIndex *ix, const PositionBook *book);
+
+/*
+** Candidate rows for a case-insensitive substring query. Writes a bitmap
+** over [0, ix->count) into out and returns 1, or returns 0 (out untouched)
+** when the needle is shorter than a trigram and cannot be narrowed.
+*/
+int  tri_candidates(const TrigramIndex *ix, const char *needle, uint64_t *out);
+
+/* ---- 1 if row's text contains the lowercased needle (nlen bytes) ---- */
+int  tri_row_match(const TrigramIndex *ix, int row, const char *needle, int nlen);
+
+#endif
@@ -0,0 +1,123 @@
+/*
+** vega.c — Swaption Vega Cube (currency x desk x expiry x tenor)
+*/
+
+#include <string.h>
+#include "vega.h"
+#include "agg.h"
+
+/* Bracket x on axis: nodes lo, hi = lo + 1 with hi's weight, clamped */
+static void bracket(const float *axis, int n, float x, int *lo, float *w_hi) {
+  if (x <= axis[0])     { *lo = 0;     *w_hi = 0; return; }
+  if (x >= axis[n - 1]) { *lo = n - 2; *w_hi = 1; return; }
+  int i = 0;
+  while (x > axis[i + 1]) i++;
+  *lo   = i;
+  *w_hi = (x - axis[i]) / (axis[i + 1] - axis[i]);
+}
+
+/* Grid nodes and bilinear weights of row */
+static void place(VegaCube *vc, const Position *p, int row) {
+  int   e, t;
+  float we, wt;
+  bracket(VEGA_EXPIRY_YEARS, VEGA_EXPIRIES, p->expiry, &e, &we);
+  bracket(VEGA_TENOR_YEARS,  VEGA_TENORS,   p->tenor,  &t, &wt);
+  for (int k = 0; k < 4; k++) {
+    int de = k >> 1, dt = k & 1;
+    vc->node[row][k] = (uint8_t)((e + de) * VEGA_TENORS + t + dt);
+    vc->w[row][k]    = (de ? (double)we : 1 - (double)we) * (dt ? (double)wt : 1 - (double)wt);
+  }
+}
+
+/* Add d of vega at row's nodes to m, and to the margins they lie on */
+static void spread(VegaMatrix *m, const VegaCube *vc, int row, double d) {
+  double *v = &m->v[0][0];
+  for (int k = 0; k < 4; k++) {
+    int    node = vc->node[row][k];
+    double x    = d * vc->w[row][k];
+    v[node]                       += x;
+    m->expiry[node / VEGA_TENORS] += x;
+    m->tenor[node % VEGA_TENORS]  += x;
+  }
+  m->total += d;
+}
+
+/* Slice index for key, appending on first sight (rebuilds only) */
+static int slice_of(VegaCube *vc, uint32_t key) {
+  for (int i = 0; i < vc->count; i++) {
+    if (vc->keys[i] == key) return i;
+  }
+  int i = vc->count++;
+  vc->keys[i] = key;
+  memset(&vc->slices[i], 0, sizeof(vc->slices[i]));
+  return i;
+}
+
+static void rebuild(VegaCube *vc, const PositionBook *book) {
+  static const GroupSpec by = { { GROUP_CCY, GROUP_DESK }, 2 };
+  vc->count = 0;
+  memset(&vc->total, 0, sizeof(vc->total));
+  memset(vc->in, 0, sizeof(vc->in));
+  for (int i = 0; i < book->count; i++) {
+    const Position *p = &book->items[i];
+    if (p->asset_class != ASSET_SWAPTION || p->expiry <= 0) continue;
+    sel_set(vc->in, i);
+    place(vc, p, i);
+    int s = slice_of(vc, group_row_key(&by, book, i));
+    vc->slice[i] = (uint8_t)s;
+    vc->last[i]  = p->vega;
+    vc->slices[s].count++;
+    vc->total.count++;
+    spread(&vc->slices[s], vc, i, p->vega);
+    spread(&vc->total, vc, i, p->vega);
+  }
+  /* The book-wide figure from the compensated kernel, not the adds above */
+  vc->total.total = agg_sum(book->cols.f64[FIELD_VEGA], vc->in, book->count);
+  vc->base_epoch  = book->value_epoch;
+  vc->rebuilds++;
+}
+
+
+void vega_sync(VegaCube *vc, const PositionBook *book) {
+  unsigned behind = book->value_epoch - vc->value_epoch;
+  int same = vc->valid && vc->book == book && vc->struct_epoch == book->struct_epoch;
+  if (same && behind == 0) return;
+
+  if (!same || behind > BOOK_LOG_LEN || book->value_epoch - vc->base_epoch >= BOOK_REBASE_EPOCHS) {
+    rebuild(vc, book);
+  } else {
+    for (unsigned e = vc->value_epoch; e != book->value_epoch; e++) {
+      int row = book->log.rows[e % BOOK_LOG_LEN];
+      if (!sel_test(vc->in, row)) continue;
+      double d = book->items[row].vega - vc->last[row];
+      if (d == 0) continue;                 /* price-only edit */
+      vc->last[row] = book->items[row].vega;
+      spread(&vc->slices[vc->slice[row]], vc, row, d);
+      spread(&vc->total, vc, row, d);
+    }
+  }
+  vc->book         = book;
+  vc->struct_epoch = book->struct_epoch;
+  vc->value_epoch  = book->value_epoch;
+  vc->valid        = 1;
+}
+
+
+void vega_matrix(const VegaCube *vc, VegaLevel level, uint32_t key, VegaMatrix *out) {
+  if (level == VEGA_ALL) {
+    *out = vc->total;
+    return;
+  }
+  memset(out, 0, sizeof(*out));
+  for (int i = 0; i < vc->count; i++) {
+    uint32_t k = vc->keys[i];
+    if (level == VEGA_CCY ? (k & 0xFFu) != key : k != key) continue;
+    const double *src = &vc->slices[i].v[0][0];
+    double       *dst = &out->v[0][0];
+    for (int n = 0; n < VEGA_EXPIRIES * VEGA_TENORS; n++) dst[n] += src[n];
+    for (int e = 0; e < VEGA_EXPIRIES; e++) out->expiry[e] += vc->slices[i].expiry[e];
+    for (int t = 0; t < VEGA_TENORS; t++)   out->tenor[t]  += vc->slices[i].tenor[t];
+    out->total += vc->slices[i].total;
+    out->count += vc->slices[i].count;
+  }
+}
@@ -0,0 +1,88 @@
+/*
+** vega.h — Swaption Vega Cube (currency x desk x expiry x tenor)
+**
+** Buckets the vega of every swaption (Position.expiry / .tenor set) onto
+** the standard expiry x tenor grid: each row's vega is split bilinearly
+** over the four grid nodes around its (expiry, tenor), clamped at the
+** edges. One dense matrix per currency + desk slice, plus the whole book.
+**
+** A row's nodes and weights are fixed when it is added (they depend only
+** on its expiry and tenor), and the cube remembers the vega it last
+** added. Ticks replayed from the book's journal (BookLog) move the row's
+** slice and the total by the difference — four multiply-adds each — so
+** the matrix stays live under a stream of vol and risk updates; only new
+** rows, an overrun journal or BOOK_REBASE_EPOCHS edits (re-basing away
+** the rounding the deltas picked up) rebuild.
+*/
+
+#ifndef VEGA_H
+#define VEGA_H
+
+#include <stdint.h>
+#include "data.h"
+#include "group.h"
+
+#define VEGA_EXPIRIES 7
+#define VEGA_TENORS   6
+
+static const float VEGA_EXPIRY_YEARS[VEGA_EXPIRIES] __attribute__((unused)) = {
+  1.0f / 12, 0.25f, 0.5f, 1, 2, 5, 10
+};
+static const char *const VEGA_EXPIRY_LABELS[VEGA_EXPIRIES] __attribute__((unused)) = {
+  "1M", "3M", "6M", "1Y", "2Y", "5Y", "10Y"
+};
+static const float VEGA_TENOR_YEARS[VEGA_TENORS] __attribute__((unused)) = {
+  1, 2, 5, 10, 20, 30
+};
+static const char *const VEGA_TENOR_LABELS[VEGA_TENORS] __attribute__((unused)) = {
+  "1Y", "2Y", "5Y", "10Y", "20Y", "30Y"
+};
+
+typedef struct {
+  double    v[VEGA_EXPIRIES][VEGA_TENORS];
+  double    expiry[VEGA_EXPIRIES];          /* row margins: sum over tenors */
+  double    tenor[VEGA_TENORS];             /* column margins: sum over expiries */
+  double    total;
+  int       count;                          /* swaptions in it */
+} VegaMatrix;
+
+/* ---- Which part of the cube to read ---- */
+typedef enum {
+  VEGA_ALL,                                 /* every swaption */
+  VEGA_CCY,                                 /* one currency, all desks */
+  VEGA_SLICE                                /* one currency + desk */
+} VegaLevel;
+
+typedef struct {
+  VegaMatrix  slices[GROUP_MAX];            /* first-appearance order */
+  uint32_t    keys[GROUP_MAX];              /* ccy id | desk id << 8 */
+  int         count;
+  VegaMatrix  total;
+
+  /* Per row: slice, grid nodes (expiry * VEGA_TENORS + tenor), weights */
+  uint64_t    in[SEL_WORDS(MAX_POSITIONS)]; /* swaption rows */
+  uint8_t     slice[MAX_POSITIONS];
+  uint8_t     node[MAX_POSITIONS][4];
+  double      w[MAX_POSITIONS][4];          /* double: they sum to 1 to the ulp */
+  double      last[MAX_POSITIONS];          /* vega last added */
+
+  const PositionBook *book;
+  unsigned    struct_epoch;
+  unsigned    value_epoch;                  /* journal replayed up to */
+  unsigned    base_epoch;                   /* value_epoch of the last rebuild */
+  unsigned    rebuilds;
+  int         valid;
+} VegaCube;
+
+/* ---- Replay the book's edits since the last call (rebuilds on new rows) ---- */
+void vega_sync(VegaCube *vc, const PositionBook *book);
+
+/*
+** ---- Matrix for a level ----
+** VEGA_ALL ignores key; VEGA_CCY takes a currency id; VEGA_SLICE a slice
+** key (ccy id | desk id << 8). Sums the matching slices into out,
+** margins included.
+*/
+void vega_matrix(const VegaCube *vc, VegaLevel level, uint32_t key, VegaMatrix *out);
+
+#endif
@@ -0,0 +1,233 @@
+/*
+** worker.c — Background filter evaluation pool
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "worker.h"
+
+#define WORKER_SLOTS MAX_VIEWS
+
+typedef enum {
+  SLOT_FREE,        /* no owner                            */
+  SLOT_IDLE,        /* owner known, nothing outstanding    */
+  SLOT_QUEUED,      /* job waiting for the thread          */
+  SLOT_RUNNING,     /* thread is evaluating generation gen */
+  SLOT_DONE         /* result for generation gen published */
+} SlotState;
+
+/* One per view. Inputs are written by submit; `match` holds the base on
+   submit and the published result once DONE. */
+typedef struct {
+  unsigned      owner;
+  unsigned      gen;
+  SlotState     state;
+  ScreenFilter  filter;
+  unsigned      filter_epoch;
+  ScreenMatch   match;
+  PositionBook  book;                   /* snapshot taken at submit */
+} Slot;
+
+/* Per-thread evaluation state. Each pool thread owns one; when the pool
+   isn't running, submit evaluates inline with s_ctx[0]. */
+typedef struct {
+  pthread_t     thread;
+  PositionBook  book;                   /* snapshot being evaluated */
+  ScreenFilter  filter;
+  unsigned      filter_epoch;
+  ScreenMatch   match;
+  TrigramIndex  index;
+  Query         query;
+} WorkerCtx;
+
+static Slot            s_slots[WORKER_SLOTS];
+static WorkerCtx       s_ctx[WORKER_MAX_THREADS];
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  s_work = PTHREAD_COND_INITIALIZER;   /* job queued / stop */
+static pthread_cond_t  s_done = PTHREAD_COND_INITIALIZER;   /* result published  */
+static int             s_running;
+static int             s_threads;
+static unsigned        s_gen;
+static int             s_rr;                                /* round-robin cursor */
+
+
+/* Slot for owner, claiming a free one if needed. Caller holds s_lock. */
+static Slot *slot_for(unsigned owner, int claim) {
+  Slot *free_slot = NULL;
+  for (int i = 0; i < WORKER_SLOTS; i++) {
+    Slot *sl = &s_slots[i];
+    if (sl->state != SLOT_FREE && sl->owner == owner) return sl;
+    if (!free_slot && sl->state == SLOT_FREE) free_slot = sl;
+  }
+  if (claim && free_slot) {
+    free_slot->owner = owner;
+    free_slot->state = SLOT_IDLE;
+  }
+  return claim ? free_slot : NULL;
+}
+
+/* Copy a slot's inputs into a thread's context. Caller holds s_lock. */
+static void take(WorkerCtx *cx, const Slot *sl) {
+  memcpy(&cx->book, &sl->book, sizeof(cx->book));
+  cx->filter       = sl->filter;
+  cx->filter_epoch = sl->filter_epoch;
+  cx->match        = sl->match;
+}
+
+static void evaluate(WorkerCtx *cx) {
+  screen_match_build(&cx->match, &cx->filter, cx->filter_epoch, &cx->book,
+                     &cx->index, &cx->query);
+}
+
+static Slot *next_queued(void) {
+  for (int k = 0; k < WORKER_SLOTS; k++) {
+    Slot *sl = &s_slots[(s_rr + k) % WORKER_SLOTS];
+    if (sl->state == SLOT_QUEUED) {
+      s_rr = (s_rr + k + 1) % WORKER_SLOTS;
+      return sl;
+    }
+  }
+  return NULL;
+}
+
+
+static void *worker_main(void *arg) {
+  WorkerCtx *cx = arg;
+  pthread_mutex_lock(&s_lock);
+  while (s_running) {
+    Slot *sl = next_queued();
+    if (!sl) {
+      pthread_cond_wait(&s_work, &s_lock);
+      continue;
+    }
+
+    unsigned owner = sl->owner, gen = sl->gen;
+    take(cx, sl);
+    sl->state = SLOT_RUNNING;
+    pthread_mutex_unlock(&s_lock);
+
+    evaluate(cx);
+
+    pthread_mutex_lock(&s_lock);
+    /* Publish only if nobody resubmitted or released meanwhile; otherwise
+       the slot is QUEUED again (newer generation) or FREE */
+    if (sl->owner == owner && sl->gen == gen && sl->state == SLOT_RUNNING) {
+      sl->match = cx->match;
+      sl->state = SLOT_DONE;
+      pthread_cond_broadcast(&s_done);
+    }
+  }
+  pthread_mutex_unlock(&s_lock);
+  return NULL;
+}
+
+
+/* ============================================================================
+**  Public API (UI thread)
+** ============================================================================*/
+
+int worker_start(void) {
+  if (s_running) return 0;
+
+  /* One thread per spare core, capped at WORKER_MAX_THREADS */
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  int  want  = (cores > 1) ? (int)(cores - 1) : 1;
+  if (want > WORKER_MAX_THREADS) want = WORKER_MAX_THREADS;
+
+  s_running = 1;
+  for (s_threads = 0; s_threads < want; s_threads++) {
+    if (pthread_create(&s_ctx[s_threads].thread, NULL, worker_main,
+                       &s_ctx[s_threads]) != 0) break;
+  }
+  if (s_threads == 0) {
+    s_running = 0;
+    return -1;
+  }
+  return 0;
+}
+
+
+int worker_threads(void) {
+  return s_threads;
+}
+
+
+void worker_stop(void) {
+  if (!s_running) return;
+  pthread_mutex_lock(&s_lock);
+  s_running = 0;
+  pthread_cond_broadcast(&s_work);
+  pthread_mutex_unlock(&s_lock);
+  for (int i = 0; i < s_threads; i++) pthread_join(s_ctx[i].thread, NULL);
+  s_threads = 0;
+}
+
+
+unsigned worker_submit(unsigned owner, const ScreenFilter *f, unsigned filter_epoch,
+                       const ScreenMatch *base, const PositionBook *book)
+{
+  pthread_mutex_lock(&s_lock);
+  Slot *sl = slot_for(owner, 1);
+  unsigned gen = ++s_gen;
+  if (!sl) {                            /* more views than slots: can't happen */
+    pthread_mutex_unlock(&s_lock);
+    return gen;
+  }
+
+  sl->gen          = gen;
+  sl->filter       = *f;
+  sl->filter_epoch = filter_epoch;
+  sl->match        = *base;
+  memcpy(&sl->book, book, sizeof(sl->book));
+
+  if (s_running) {
+    sl->state = SLOT_QUEUED;
+    pthread_cond_signal(&s_work);
+  } else {
+    take(&s_ctx[0], sl);
+    evaluate(&s_ctx[0]);
+    sl->match = s_ctx[0].match;
+    sl->state = SLOT_DONE;
+  }
+  pthread_mutex_unlock(&s_lock);
+  return gen;
+}
+
+
+int worker_collect(unsigned owner, unsigned gen, ScreenMatch *out) {
+  int got = 0;
+  pthread_mutex_lock(&s_lock);
+  Slot *sl = slot_for(owner, 0);
+  if (sl && sl->state == SLOT_DONE && sl->gen == gen) {
+    *out      = sl->match;
+    sl->state = SLOT_IDLE;
+    got       = 1;
+  }
+  pthread_mutex_unlock(&s_lock);
+  return got;
+}
+
+
+void worker_wait(unsigned owner, unsigned gen, ScreenMatch *out) {
+  pthread_mutex_lock(&s_lock);
+  Slot *sl = slot_for(owner, 0);
+  while (sl && sl->gen == gen && sl->state != SLOT_DONE) {
+    pthread_cond_wait(&s_done, &s_lock);
+  }
+  if (sl && sl->state == SLOT_DONE && sl->gen == gen) {
+    *out      = sl->match;
+    sl->state = SLOT_IDLE;
+  }
+  pthread_mutex_unlock(&s_lock);
+}
+
+
+void worker_release(unsigned owner) {
+  pthread_mutex_lock(&s_lock);
+  Slot *sl = slot_for(owner, 0);
+  if (sl) sl->state = SLOT_FREE;
+  pthread_mutex_unlock(&s_lock);
+}
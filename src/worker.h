@@ -0,0 +1,55 @@
+/*
+** worker.h — Background Filter Evaluation
+**
+** Filter rebuilds (screen_match_build) run on a small thread pool so a
+** keystroke, checkbox toggle or book change never stalls the frame. The
+** UI thread submits a job per view (screen.h) — a snapshot of the book
+** plus the view's filter and its previous result — and keeps drawing the
+** previous result until the new one is collected. Jobs for different
+** views run in parallel, one view per thread at a time.
+**
+** Cancellation is by generation: each submit gets a new generation and
+** replaces whatever that view had queued. A job already running for an
+** older generation is finished but its result is dropped, and the newer
+** job runs next. Only the latest generation is ever published.
+**
+** Each pool thread owns its trigram index and query scratch; none touches
+** the live book. If the pool isn't running, submit evaluates inline.
+** Sorting and totals are not jobs: they run on the UI thread (screen.h).
+*/
+
+#ifndef WORKER_H
+#define WORKER_H
+
+#include "data.h"
+#include "screen.h"
+
+#define WORKER_MAX_THREADS MAX_SCREENS
+
+/* ---- Start the pool (one thread per spare core). Returns 0 on success. ---- */
+int  worker_start(void);
+
+/* ---- Stop and join all pool threads ---- */
+void worker_stop(void);
+
+/* ---- Number of pool threads running (0 = inline evaluation) ---- */
+int  worker_threads(void);
+
+/*
+** Queue a rebuild for view `owner` (ScreenView.uid) from a snapshot of book,
+** superseding any queued job for that owner. base is the view's current
+** result (used for refinement). Returns the job's generation.
+*/
+unsigned worker_submit(unsigned owner, const ScreenFilter *f, unsigned filter_epoch,
+                       const ScreenMatch *base, const PositionBook *book);
+
+/* ---- Copy out the result of generation gen if published. Returns 1 if so. ---- */
+int  worker_collect(unsigned owner, unsigned gen, ScreenMatch *out);
+
+/* ---- Block until generation gen is published, then collect it ---- */
+void worker_wait(unsigned owner, unsigned gen, ScreenMatch *out);
+
+/* ---- Drop any job / result for owner (view dropped) ---- */
+void worker_release(unsigned owner);
+
+#endif